@@ -0,0 +1,360 @@
+// Микробенчмарки Vector против std::vector.
+// Собирается отдельной программой:
+//   g++ -std=c++17 -O2 -DNDEBUG benchmark.cpp -o benchmark
+// Каждый сценарий прогревается, затем прогоняется несколько раз;
+// в отчёт идёт лучшее время — ns/op и миллионы операций в секунду.
+#include "vector.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+// Аппаратные счётчики вокруг измеряемого региона через perf_event_open:
+// такты, инструкции, промахи LLC и dTLB. Счётчики ловят регрессии
+// раскладки памяти, которые не видны по количеству перемещений — число
+// move может не измениться, а промахи кеша удвоиться.
+// Если perf недоступен (контейнер, perf_event_paranoid), бенчмарк
+// работает как раньше и печатает только время
+class PerfCounters {
+public:
+    static constexpr size_t NUM_EVENTS = 4;
+    static constexpr const char* NAMES[NUM_EVENTS] = {"cyc", "ins", "LLCm", "TLBm"};
+
+    PerfCounters() {
+        fds_[0] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds_[1] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds_[2] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds_[3] = OpenCounter(PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    // true, если открылся хотя бы один счётчик
+    bool Available() const {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Start() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void Stop() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+    }
+
+    // Значение счётчика event после Stop(); -1, если счётчик не открылся
+    long long Value(size_t event) const {
+        if (fds_[event] < 0) {
+            return -1;
+        }
+        long long value = 0;
+        if (read(fds_[event], &value, sizeof(value)) != sizeof(value)) {
+            return -1;
+        }
+        return value;
+    }
+
+private:
+    static int OpenCounter(uint32_t type, uint64_t config) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    int fds_[NUM_EVENTS];
+};
+#endif  // __linux__
+
+// Не даёт оптимизатору выбросить вычисленное значение
+template <typename T>
+void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Гоняет fn (один прогрев + REPS замеров), печатает лучшее время на операцию
+template <typename Fn>
+void RunBench(const std::string& name, size_t ops_per_iter, Fn fn) {
+    using namespace std::chrono;
+    constexpr int REPS = 5;
+
+    fn();  // прогрев: страницы, кеши, инстанцирование
+
+    double best_ns = std::numeric_limits<double>::max();
+    for (int rep = 0; rep < REPS; ++rep) {
+        const auto start = steady_clock::now();
+        fn();
+        const auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+        best_ns = std::min(best_ns, static_cast<double>(elapsed.count()));
+    }
+
+    const double ns_per_op = best_ns / static_cast<double>(ops_per_iter);
+    const double mops = 1e3 / ns_per_op;
+    std::cout << std::left << std::setw(44) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << ns_per_op << " ns/op"
+              << std::setw(10) << mops << " Mop/s";
+
+#if defined(__linux__)
+    // Дополнительный прогон под аппаратными счётчиками: такты, инструкции
+    // и промахи на операцию. Отдельно от замеров времени, чтобы ioctl
+    // не искажал лучший результат
+    PerfCounters counters;
+    if (counters.Available()) {
+        counters.Start();
+        fn();
+        counters.Stop();
+        for (size_t event = 0; event != PerfCounters::NUM_EVENTS; ++event) {
+            const long long value = counters.Value(event);
+            if (value >= 0) {
+                std::cout << std::setprecision(3) << std::setw(9)
+                          << static_cast<double>(value) / static_cast<double>(ops_per_iter)
+                          << ' ' << PerfCounters::NAMES[event] << "/op";
+            }
+        }
+    }
+#endif
+    std::cout << std::endl;
+}
+
+// Единый интерфейс к Vector и std::vector, чтобы сценарии писались один раз
+template <typename C>
+struct Ops;
+
+template <typename T, typename A, typename G>
+struct Ops<Vector<T, A, G>> {
+    using Container = Vector<T, A, G>;
+    static void Push(Container& c, T value) {
+        c.PushBack(std::move(value));
+    }
+    static void Reserve(Container& c, size_t n) {
+        c.Reserve(n);
+    }
+    static void InsertFront(Container& c, T value) {
+        c.Insert(c.cbegin(), std::move(value));
+    }
+    static void EraseFront(Container& c) {
+        c.Erase(c.cbegin());
+    }
+    static void Resize(Container& c, size_t n) {
+        c.Resize(n);
+    }
+    static size_t Size(const Container& c) {
+        return c.Size();
+    }
+};
+
+template <typename T, typename A>
+struct Ops<std::vector<T, A>> {
+    using Container = std::vector<T, A>;
+    static void Push(Container& c, T value) {
+        c.push_back(std::move(value));
+    }
+    static void Reserve(Container& c, size_t n) {
+        c.reserve(n);
+    }
+    static void InsertFront(Container& c, T value) {
+        c.insert(c.cbegin(), std::move(value));
+    }
+    static void EraseFront(Container& c) {
+        c.erase(c.cbegin());
+    }
+    static void Resize(Container& c, size_t n) {
+        c.resize(n);
+    }
+    static size_t Size(const Container& c) {
+        return c.size();
+    }
+};
+
+// Фабрики элементов для трёх классов типов
+uint64_t MakeValue(size_t i, uint64_t*) {
+    return i;
+}
+
+std::string MakeValue(size_t i, std::string*) {
+    return "element #" + std::to_string(i);
+}
+
+std::unique_ptr<uint64_t> MakeValue(size_t i, std::unique_ptr<uint64_t>*) {
+    return std::make_unique<uint64_t>(i);
+}
+
+// Сводит элемент к числу для сценария линейного сканирования
+size_t ScanValue(uint64_t x) {
+    return x;
+}
+
+size_t ScanValue(const std::string& s) {
+    return s.size();
+}
+
+size_t ScanValue(const std::unique_ptr<uint64_t>& p) {
+    return *p;
+}
+
+template <typename C, typename T>
+void BenchPushBackGrowth(const std::string& name, size_t count) {
+    RunBench(name, count, [count] {
+        C v;
+        for (size_t i = 0; i < count; ++i) {
+            Ops<C>::Push(v, MakeValue(i, static_cast<T*>(nullptr)));
+        }
+        DoNotOptimize(Ops<C>::Size(v));
+    });
+}
+
+template <typename C, typename T>
+void BenchReserveFill(const std::string& name, size_t count) {
+    RunBench(name, count, [count] {
+        C v;
+        Ops<C>::Reserve(v, count);
+        for (size_t i = 0; i < count; ++i) {
+            Ops<C>::Push(v, MakeValue(i, static_cast<T*>(nullptr)));
+        }
+        DoNotOptimize(Ops<C>::Size(v));
+    });
+}
+
+template <typename C, typename T>
+void BenchInsertEraseFront(const std::string& name, size_t count) {
+    RunBench(name, count * 2, [count] {
+        C v;
+        for (size_t i = 0; i < count; ++i) {
+            Ops<C>::InsertFront(v, MakeValue(i, static_cast<T*>(nullptr)));
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Ops<C>::EraseFront(v);
+        }
+        DoNotOptimize(Ops<C>::Size(v));
+    });
+}
+
+// Линейное сканирование заполненного контейнера: на нём лучше всего
+// видны промахи LLC/dTLB из-за раскладки буфера
+template <typename C, typename T>
+void BenchScan(const std::string& name, size_t count) {
+    C v;
+    for (size_t i = 0; i < count; ++i) {
+        Ops<C>::Push(v, MakeValue(i, static_cast<T*>(nullptr)));
+    }
+    RunBench(name, count, [&v] {
+        size_t acc = 0;
+        for (const auto& item : v) {
+            acc += ScanValue(item);
+        }
+        DoNotOptimize(acc);
+    });
+}
+
+template <typename C, typename T>
+void BenchCopyAssign(const std::string& name, size_t count) {
+    C src;
+    for (size_t i = 0; i < count; ++i) {
+        Ops<C>::Push(src, MakeValue(i, static_cast<T*>(nullptr)));
+    }
+    RunBench(name, count, [&src] {
+        C dst;
+        dst = src;
+        DoNotOptimize(Ops<C>::Size(dst));
+    });
+}
+
+template <typename C, typename T>
+void BenchMoveAssign(const std::string& name, size_t count) {
+    RunBench(name, count, [count] {
+        C src;
+        for (size_t i = 0; i < count; ++i) {
+            Ops<C>::Push(src, MakeValue(i, static_cast<T*>(nullptr)));
+        }
+        C dst;
+        dst = std::move(src);
+        DoNotOptimize(Ops<C>::Size(dst));
+    });
+}
+
+template <typename C, typename T>
+void BenchResize(const std::string& name, size_t count) {
+    RunBench(name, count, [count] {
+        C v;
+        Ops<C>::Resize(v, count);
+        DoNotOptimize(Ops<C>::Size(v));
+    });
+}
+
+// Пара сценариев "наш Vector / std::vector" c одинаковыми параметрами
+template <typename T>
+void BenchTypeSuite(const std::string& type_name, size_t count, size_t insert_count) {
+    BenchPushBackGrowth<Vector<T>, T>("PushBack/growth/" + type_name + "/Vector", count);
+    BenchPushBackGrowth<std::vector<T>, T>("PushBack/growth/" + type_name + "/std", count);
+    BenchReserveFill<Vector<T>, T>("Reserve+fill/" + type_name + "/Vector", count);
+    BenchReserveFill<std::vector<T>, T>("Reserve+fill/" + type_name + "/std", count);
+    BenchScan<Vector<T>, T>("Scan/" + type_name + "/Vector", count);
+    BenchScan<std::vector<T>, T>("Scan/" + type_name + "/std", count);
+    BenchInsertEraseFront<Vector<T>, T>("Insert+Erase/front/" + type_name + "/Vector",
+        insert_count);
+    BenchInsertEraseFront<std::vector<T>, T>("Insert+Erase/front/" + type_name + "/std",
+        insert_count);
+    BenchMoveAssign<Vector<T>, T>("MoveAssign/" + type_name + "/Vector", count);
+    BenchMoveAssign<std::vector<T>, T>("MoveAssign/" + type_name + "/std", count);
+    BenchResize<Vector<T>, T>("Resize/" + type_name + "/Vector", count);
+    BenchResize<std::vector<T>, T>("Resize/" + type_name + "/std", count);
+    if constexpr (std::is_copy_constructible_v<T>) {
+        BenchCopyAssign<Vector<T>, T>("CopyAssign/" + type_name + "/Vector", count);
+        BenchCopyAssign<std::vector<T>, T>("CopyAssign/" + type_name + "/std", count);
+    }
+}
+
+}  // namespace
+
+int main() {
+    const size_t COUNT = 1'000'000;
+    const size_t INSERT_COUNT = 10'000;
+
+    BenchTypeSuite<uint64_t>("u64", COUNT, INSERT_COUNT);
+    BenchTypeSuite<std::string>("string", COUNT / 10, INSERT_COUNT / 10);
+    BenchTypeSuite<std::unique_ptr<uint64_t>>("move_only", COUNT / 10, INSERT_COUNT / 10);
+}
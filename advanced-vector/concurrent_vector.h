@@ -0,0 +1,84 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+
+// ConcurrentVector — буфер фиксированной ёмкости для многопоточного
+// заполнения. Производители захватывают слоты атомарным fetch-add курсора
+// и конструируют элементы на месте (тем же размещающим new, что и
+// EmplaceBack у Vector), поэтому несколько потоков пишут прямо в итоговый
+// буфер без приватных векторов и финального слияния. Seal() отдаёт
+// заполненный буфер обычному Vector без копирования элементов.
+//
+// Контракт:
+//  - ёмкость задаётся при создании и не растёт; переполнившийся
+//    TryEmplaceBack возвращает nullptr, и вызывающий решает, что делать;
+//  - конструктор элемента не должен бросать: захваченный слот нельзя
+//    вернуть, и при исключении он остался бы несконструированным;
+//  - Seal() и деструктор можно звать только после того, как все
+//    производители закончили (обычно — после join потоков): завершение
+//    потока и даёт happens-before для записанных элементов
+template <typename T, typename Alloc = std::allocator<T>>
+class ConcurrentVector {
+public:
+    explicit ConcurrentVector(size_t capacity, const Alloc& alloc = Alloc{})
+        : data_(capacity, alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        detail::DestroyN(data_.GetAddress(), Size());
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Число заполненных слотов. Осмысленно только после join всех
+    // производителей: слот захватывается fetch-add ДО конструирования
+    // элемента, поэтому во время гонки счётчик может опережать реально
+    // построенные элементы, и читать [0, Size()) в этот момент нельзя
+    size_t Size() const noexcept {
+        return std::min(cursor_.load(std::memory_order_acquire), data_.Capacity());
+    }
+
+    // Захватывает слот и конструирует элемент на месте. Возвращает
+    // указатель на построенный элемент либо nullptr, если буфер полон.
+    // Потокобезопасен относительно других Try*Back
+    template <typename... Args>
+    T* TryEmplaceBack(Args&&... args) {
+        static_assert(std::is_nothrow_constructible_v<T, Args&&...>,
+            "бросивший конструктор оставил бы захваченный слот пустым");
+        const size_t slot = cursor_.fetch_add(1, std::memory_order_relaxed);
+        if (slot >= data_.Capacity()) {
+            return nullptr;
+        }
+        return detail::ConstructAt(data_.GetAddress() + slot, std::forward<Args>(args)...);
+    }
+
+    bool TryPushBack(const T& value) {
+        return TryEmplaceBack(value) != nullptr;
+    }
+
+    bool TryPushBack(T&& value) {
+        return TryEmplaceBack(std::move(value)) != nullptr;
+    }
+
+    // Передаёт буфер обычному Vector без копирования элементов; контейнер
+    // остаётся пустым с нулевой ёмкостью. Звать строго после join
+    // производителей
+    Vector<T, Alloc> Seal() {
+        const size_t size = Size();
+        const size_t capacity = data_.Capacity();
+        const Alloc alloc = data_.GetAllocator();
+        T* buffer = data_.Release();
+        cursor_.store(0, std::memory_order_relaxed);
+        return Vector<T, Alloc>::AdoptBuffer(buffer, size, capacity, alloc);
+    }
+
+private:
+    RawMemory<T, Alloc> data_;
+    std::atomic<size_t> cursor_{0};
+};
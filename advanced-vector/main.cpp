@@ -1,11 +1,20 @@
 #include "vector.h"
+#include "small_vector.h"
+#include "concurrent_vector.h"
+#include "segmented_vector.h"
 
 #include <iostream>
+#include <cstdio>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 #include <algorithm>
 
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+
 namespace {
 
 // "Магическое" число, используемое для отслеживания живости объекта
@@ -559,86 +568,1261 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+// Аллокатор, считающий выделения и освобождения, — для проверки,
+// что вся память Vector проходит через пользовательский аллокатор
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+
+    T* allocate(size_t n) {
+        ++num_allocations;
+        return std::allocator<T>{}.allocate(n);
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+
+    void deallocate(T* p, size_t n) noexcept {
+        ++num_deallocations;
+        std::allocator<T>{}.deallocate(p, n);
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+
+    bool operator==(const CountingAllocator&) const noexcept {
+        return true;
+    }
+
+    bool operator!=(const CountingAllocator&) const noexcept {
+        return false;
+    }
+
+    static inline int num_allocations = 0;
+    static inline int num_deallocations = 0;
+};
+
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+// Таблица, целиком построенная Vector'ом на этапе компиляции
+constexpr int SumOfSquares(int n) {
+    Vector<int> v;
+    v.Reserve(4);  // заведомо меньше n — рост тоже проверяем
+    for (int i = 1; i <= n; ++i) {
+        v.PushBack(i * i);
+    }
+    Vector<int> copy(v);
+    copy.ShrinkToFit();
+    int sum = 0;
+    for (int x : copy) {
+        sum += x;
+    }
+    return sum;
+}
+
+static_assert(SumOfSquares(10) == 385);
+#endif
+
+void TestAllocatorAware() {
+    using Alloc = CountingAllocator<int>;
+    Alloc::num_allocations = 0;
+    Alloc::num_deallocations = 0;
+    {
+        Vector<int, Alloc> v;
+        assert(Alloc::num_allocations == 0);
+        v.Reserve(10);
+        assert(Alloc::num_allocations == 1);
+        for (int i = 0; i < 20; ++i) {
+            v.PushBack(i);
         }
-        return *this;
+        assert(v.Size() == 20);
+        assert(v[19] == 19);
+        assert(Alloc::num_allocations == 2);
+
+        Vector<int, Alloc> v_copy(v);
+        assert(Alloc::num_allocations == 3);
+        Vector<int, Alloc> v_moved(std::move(v_copy));
+        assert(Alloc::num_allocations == 3);
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+    assert(Alloc::num_allocations == Alloc::num_deallocations);
+}
+
+void TestReallocExtend() {
+    {
+        // Рост через ReallocAllocator сохраняет содержимое буфера
+        Vector<int, ReallocAllocator<int>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == 1000);
+        for (int i = 0; i < 1000; ++i) {
+            assert(v[i] == i);
+        }
+        v.Reserve(5000);
+        assert(v.Capacity() == 5000);
+        assert(v[999] == 999);
+    }
+    {
+        // PushBack существующего элемента безопасен и на realloc-пути
+        Vector<int, ReallocAllocator<int>> v;
+        v.PushBack(42);
+        assert(v.Size() == v.Capacity());
+        v.PushBack(v[0]);
+        assert(v[1] == 42);
     }
-    ~C() {
-        ++dtor;
+    {
+        // Вставка в середину при заполненном realloc-буфере
+        Vector<int, ReallocAllocator<int>> v;
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == v.Capacity());
+        auto* pos = v.Insert(v.cbegin() + 2, 42);
+        assert(*pos == 42);
+        assert(v[1] == 1 && v[3] == 2 && v[4] == 3);
     }
+}
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+void TestAlignedAllocator() {
+    constexpr size_t ALIGN = 64;
+    Vector<float, AlignedAllocator<float, ALIGN>> v;
+    for (int i = 0; i < 1000; ++i) {
+        v.PushBack(static_cast<float>(i));
+        // Буфер выровнен по кеш-линии после каждой реаллокации
+        assert(reinterpret_cast<uintptr_t>(&v[0]) % ALIGN == 0);
     }
+    assert(v[999] == 999.f);
+}
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
+void TestRangeOperations() {
+    using Alloc = CountingAllocator<Obj>;
+    const size_t SIZE = 10;
+    {
+        // AppendRange резервирует место один раз
+        Obj::ResetCounters();
+        Alloc::num_allocations = 0;
+        std::vector<Obj> src;
+        for (int i = 0; i < 100; ++i) {
+            src.emplace_back(i);
+        }
+        Vector<Obj, Alloc> v;
+        v.AppendRange(src.begin(), src.end());
+        assert(v.Size() == 100);
+        assert(v[99].id == 99);
+        assert(Alloc::num_allocations == 1);
+        assert(Obj::num_copied == 100);
+
+        // Повторное добавление в заполненный вектор растёт геометрически
+        v.AppendRange(src.begin(), src.begin() + 10);
+        assert(v.Size() == 110);
+        assert(v.Capacity() == 200);
+        assert(Alloc::num_allocations == 2);
+    }
+    {
+        // InsertRange сдвигает хвост ровно один раз
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 4);
+        std::vector<Obj> src;
+        src.emplace_back(1);
+        src.emplace_back(2);
+        src.emplace_back(3);
+        const int old_num_moved = Obj::num_moved;
+        auto* pos = v.InsertRange(v.cbegin() + 2, src.begin(), src.end());
+        assert(v.Size() == SIZE + 3);
+        assert(&*pos == &v[2]);
+        assert(v[2].id == 1 && v[3].id == 2 && v[4].id == 3);
+        // Хвост из 8 элементов сдвинулся за один проход: 3 переноса в сырую
+        // память плюс 5 перемещающих присваиваний
+        assert(Obj::num_moved == old_num_moved + 3);
+        assert(Obj::num_move_assigned == 5);
+        assert(Obj::num_assigned == 3);
+    }
+    {
+        // InsertRange с реаллокацией строит новый буфер за один проход
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> src(SIZE, Obj{42});
+        const int old_copied = Obj::num_copied;
+        const int old_moved = Obj::num_moved;
+        auto* pos = v.InsertRange(v.cbegin() + 5, src.begin(), src.end());
+        assert(v.Size() == SIZE * 2);
+        assert(&*pos == &v[5]);
+        assert(v[5].id == 42 && v[14].id == 42);
+        assert(Obj::num_copied == old_copied + static_cast<int>(SIZE));
+        assert(Obj::num_moved == old_moved + static_cast<int>(SIZE));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void TestInsertN() {
+    const size_t SIZE = 10;
+    {
+        // Вставка серии в середину без реаллокации: хвост сдвигается один раз
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 4);
+        const int old_num_moved = Obj::num_moved;
+        auto* pos = v.InsertN(v.cbegin() + 2, 3, Obj{7});
+        assert(v.Size() == SIZE + 3);
+        assert(&*pos == &v[2]);
+        assert(v[2].id == 7 && v[3].id == 7 && v[4].id == 7);
+        assert(v[5].id == 0);
+        // Та же форма сдвига, что у InsertRange: 3 переноса в сырую память
+        // плюс 5 перемещающих присваиваний
+        assert(Obj::num_moved == old_num_moved + 3);
+        assert(Obj::num_move_assigned == 5);
+    }
+    {
+        // Вставка, выходящая за конец хвоста: часть копий уходит в сырую память
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 4);
+        auto* pos = v.InsertN(v.cbegin() + 7, 8, Obj{9});
+        assert(v.Size() == SIZE + 8);
+        assert(&*pos == &v[7]);
+        assert(v[7].id == 9 && v[14].id == 9);
+        assert(v[15].id == 0 && v[17].id == 0);
+    }
+    {
+        // Реаллокация: новый буфер строится за один проход
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        const int old_copied = Obj::num_copied;
+        const int old_moved = Obj::num_moved;
+        auto* pos = v.InsertN(v.cbegin() + 5, SIZE, Obj{42});
+        assert(v.Size() == SIZE * 2);
+        assert(&*pos == &v[5]);
+        assert(v[5].id == 42 && v[14].id == 42);
+        assert(Obj::num_copied == old_copied + static_cast<int>(SIZE));
+        assert(Obj::num_moved == old_moved + static_cast<int>(SIZE));
+    }
+    {
+        // value может ссылаться на элемент самого вектора: копия снимается
+        // до сдвига хвоста
+        Vector<int> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+        }
+        v.Reserve(64);
+        v.InsertN(v.cbegin(), 5, v[8]);
+        assert(v.Size() == 15);
+        assert(v[0] == 8 && v[4] == 8 && v[5] == 0 && v[14] == 9);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void TestAssign() {
+    using Alloc = CountingAllocator<Obj>;
+    {
+        // Перезаливка, влезающая в ёмкость, не выделяет память:
+        // живые элементы перезаписываются присваиванием, хвост разрушается
+        Obj::ResetCounters();
+        Alloc::num_allocations = 0;
+        Vector<Obj, Alloc> v;
+        v.Reserve(100);
+        for (int i = 0; i < 50; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(Alloc::num_allocations == 1);
+
+        std::vector<Obj> src;
+        for (int i = 0; i < 30; ++i) {
+            src.emplace_back(i + 1000);
+        }
+        const int old_assigned = Obj::num_assigned;
+        v.Assign(src.begin(), src.end());
+        assert(v.Size() == 30);
+        assert(v.Capacity() == 100);
+        assert(Alloc::num_allocations == 1);
+        assert(v[0].id == 1000 && v[29].id == 1029);
+        // Все 30 элементов легли поверх живых — ровно 30 присваиваний
+        assert(Obj::num_assigned == old_assigned + 30);
+
+        // Диапазон длиннее size_, но в пределах ёмкости: часть присваивается,
+        // часть доконструируется копированием
+        src.resize(70, Obj{7});
+        v.Assign(src.begin(), src.end());
+        assert(v.Size() == 70);
+        assert(Alloc::num_allocations == 1);
+        assert(v[69].id == 7);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // При нехватке ёмкости рост геометрический, а старые элементы
+        // разрушаются до реаллокации и не переносятся в новый буфер
+        Obj::ResetCounters();
+        Vector<Obj> v(10);
+        const int old_moved = Obj::num_moved;
+        std::vector<Obj> src(15, Obj{42});
+        v.Assign(src.begin(), src.end());
+        assert(v.Size() == 15);
+        assert(v.Capacity() == 20);
+        assert(Obj::num_moved == old_moved);
+        assert(v[14].id == 42);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Assign(count, value) тем же способом переиспользует буфер
+        Vector<int> v;
+        v.Assign(5, 42);
+        assert(v.Size() == 5 && v[4] == 42);
+        const int* old_data = v.begin();
+        v.Assign(3, 7);
+        assert(v.Size() == 3 && v.Capacity() == 5);
+        assert(v.begin() == old_data);
+        assert(v[0] == 7 && v[2] == 7);
+    }
+}
+
+void TestUncheckedPushBack() {
+    {
+        // Сценарий декодера: точный Reserve, затем вставка без проверки ёмкости
+        Obj::ResetCounters();
+        const size_t COUNT = 1000;
+        Vector<Obj> v;
+        v.Reserve(COUNT);
+        const Obj* old_data = &*v.begin();
+        for (size_t i = 0; i < COUNT; ++i) {
+            Obj& ref = v.EmplaceBackUnchecked(static_cast<int>(i));
+            assert(&ref == &v[i]);
+        }
+        assert(v.Size() == COUNT);
+        assert(v.Capacity() == COUNT);
+        assert(&v[0] == old_data);
+        assert(v[COUNT - 1].id == static_cast<int>(COUNT - 1));
+        // Ни одной реаллокации — ни одного переноса
+        assert(Obj::num_moved == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<int> v;
+        v.Reserve(3);
+        int x = 1;
+        v.PushBackUnchecked(x);
+        v.PushBackUnchecked(2);
+        v.PushBackUnchecked(3);
+        assert(v.Size() == 3);
+        assert(v[0] == 1 && v[1] == 2 && v[2] == 3);
+    }
+}
+
+// Аллокатор с лимитом на размер одного блока — моделирует исчерпание памяти
+template <typename T>
+struct LimitedAllocator {
+    using value_type = T;
+
+    LimitedAllocator() = default;
+
+    template <typename U>
+    LimitedAllocator(const LimitedAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > max_block_elements) {
+            throw std::bad_alloc{};
+        }
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    bool operator==(const LimitedAllocator&) const noexcept {
+        return true;
+    }
+
+    bool operator!=(const LimitedAllocator&) const noexcept {
+        return false;
+    }
+
+    static inline size_t max_block_elements = 0;
 };
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+void TestTryApi() {
+    using Alloc = LimitedAllocator<int>;
+    Alloc::max_block_elements = 16;
+    {
+        Vector<int, Alloc> v;
+        assert(v.TryReserve(10));
+        assert(v.Capacity() == 10);
+        for (int i = 0; i < 10; ++i) {
+            assert(v.TryPushBack(i));
+        }
+        // Запрос сверх лимита проваливается, вектор остаётся нетронутым
+        assert(!v.TryReserve(1000));
+        assert(v.Capacity() == 10);
+        assert(v.Size() == 10);
+        assert(v[9] == 9);
+        // Рост 10 -> 20 упирается в лимит — TryPushBack сообщает об этом
+        assert(!v.TryPushBack(42));
+        assert(v.Size() == 10);
+        assert(v.TryEmplaceBack(10) == false);
+    }
+    Alloc::max_block_elements = 0;
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
+// Владеющий хэндл: нетривиальные перемещение и деструктор, но перенос
+// байтами корректен — внутри нет ссылок на самого себя
+struct RelocHandle {
+    explicit RelocHandle(int v)
+        : value(new int(v)) {
+    }
+
+    RelocHandle(RelocHandle&& other) noexcept
+        : value(std::exchange(other.value, nullptr)) {
+        ++num_moves;
+    }
+
+    RelocHandle& operator=(RelocHandle&& rhs) noexcept {
+        std::swap(value, rhs.value);
+        ++num_moves;
+        return *this;
+    }
+
+    ~RelocHandle() {
+        delete value;
+        ++num_dtors;
+    }
+
+    int* value;
+    static inline int num_moves = 0;
+    static inline int num_dtors = 0;
+};
+
+template <>
+struct IsTriviallyRelocatable<RelocHandle> : std::true_type {};
+
+void TestTriviallyRelocatable() {
+    static_assert(!std::is_trivially_copyable_v<RelocHandle>);
+    static_assert(IsTriviallyRelocatable<RelocHandle>::value);
+    // По умолчанию признак совпадает с тривиальной копируемостью
+    static_assert(IsTriviallyRelocatable<int>::value);
+    static_assert(!IsTriviallyRelocatable<std::string>::value);
+
+    const int COUNT = 100;
+    RelocHandle::num_moves = 0;
+    RelocHandle::num_dtors = 0;
+    {
+        Vector<RelocHandle> v;
+        for (int i = 0; i < COUNT; ++i) {
+            v.EmplaceBack(i);
+        }
+        // Все переезды буфера прошли одним memcpy: ни перемещений,
+        // ни деструкторов по старому буферу
+        assert(RelocHandle::num_moves == 0);
+        assert(RelocHandle::num_dtors == 0);
+        assert(*v[0].value == 0);
+        assert(*v[COUNT - 1].value == COUNT - 1);
+
+        v.Reserve(1000);
+        v.ShrinkToFit();
+        assert(RelocHandle::num_moves == 0);
+        assert(RelocHandle::num_dtors == 0);
+        assert(*v[COUNT - 1].value == COUNT - 1);
+    }
+    // Каждый элемент разрушен ровно один раз — двойного delete не было
+    assert(RelocHandle::num_dtors == COUNT);
+}
+
+void TestStdInterface() {
+    static_assert(std::is_same_v<Vector<int>::value_type, int>);
+    static_assert(std::is_same_v<Vector<int>::size_type, size_t>);
+    static_assert(std::is_same_v<Vector<int>::reference, int&>);
+    static_assert(std::is_same_v<Vector<int>::const_pointer, const int*>);
+    static_assert(std::is_same_v<Vector<int>::allocator_type, std::allocator<int>>);
+    {
+        Vector<int> v;
+        assert(v.empty());
+        for (int x : {3, 1, 2}) {
+            v.PushBack(x);
+        }
+        assert(!v.empty());
+        assert(v.size() == 3);
+        assert(v.data() == &v[0]);
+        assert(v.front() == 3);
+        assert(v.back() == 2);
+
+        // Обычные алгоритмы работают поверх begin()/end()
+        std::sort(v.begin(), v.end());
+        assert(v[0] == 1 && v[1] == 2 && v[2] == 3);
+
+        // Обратные итераторы обходят вектор с конца
+        const std::vector<int> reversed(v.rbegin(), v.rend());
+        assert(reversed[0] == 3 && reversed[2] == 1);
+
+        const Vector<int>& cv = v;
+        assert(cv.front() == 1 && cv.back() == 3);
+        assert(*cv.crbegin() == 3);
+        assert(cv.data() == v.data());
+    }
+#if defined(__cpp_lib_ranges)
+    {
+        // В C++20 Vector — полноценный contiguous range
+        static_assert(std::ranges::contiguous_range<Vector<int>>);
+        static_assert(std::ranges::sized_range<Vector<int>>);
+        Vector<int> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+        }
+        int sum = 0;
+        for (int x : v | std::views::filter([](int x) { return x % 2 == 0; })) {
+            sum += x;
+        }
+        assert(sum == 20);
+    }
+#endif
+}
+
+void TestStreamingFill() {
+    // Объёмы выше ADVANCED_VECTOR_STREAM_THRESHOLD уходят в потоковые
+    // записи мимо кеша; проверяем, что содержимое при этом корректно
+    // на голове, в середине и на хвосте буфера
+    const size_t BIG = 2'000'000;  // 8 МБ float при пороге 4 МБ
+    {
+        // Resize зануляет новые элементы потоковым заполнением
+        Vector<float> v;
+        v.Resize(BIG);
+        assert(v[0] == 0.0f && v[BIG / 2] == 0.0f && v[BIG - 1] == 0.0f);
+    }
+    {
+        // Assign заполняет значением
+        Vector<float> v;
+        v.Assign(BIG, 1.5f);
+        assert(v.Size() == BIG);
+        assert(v[0] == 1.5f && v[BIG / 2] == 1.5f && v[BIG - 1] == 1.5f);
+
+        // Конструктор копирования копирует потоковыми записями
+        Vector<float> copy(v);
+        assert(copy.Size() == BIG);
+        assert(copy[0] == 1.5f && copy[BIG / 2] == 1.5f && copy[BIG - 1] == 1.5f);
+    }
+    {
+        // Нетривиальные и "неудобные" по размеру типы идут обычным путём
+        struct Padded {
+            char bytes[12];
+        };
+        Vector<Padded> v;
+        v.Resize(BIG / 2);
+        assert(v.Size() == BIG / 2);
+        Vector<std::string> s;
+        s.Assign(100, std::string("x"));
+        assert(s[99] == "x");
+    }
+}
+
+void TestDefaultInitResize() {
+    {
+        // Имитация приёмного буфера: Resize до размера сообщения, затем
+        // полная перезапись содержимого
+        Vector<char> buf;
+        buf.Resize(1024, default_init);
+        assert(buf.Size() == 1024);
+        assert(buf.Capacity() == 1024);
+        std::fill(buf.begin(), buf.end(), '\xab');
+        assert(buf[0] == '\xab' && buf[1023] == '\xab');
+
+        // Сжатие и повторный рост в пределах ёмкости не трогают байты —
+        // прежнее содержимое остаётся на месте
+        buf.Resize(0, default_init);
+        assert(buf.Size() == 0);
+        assert(buf.Capacity() == 1024);
+        buf.Resize(512, default_init);
+        assert(buf[0] == '\xab' && buf[511] == '\xab');
+    }
+    {
+        // Обычный Resize по-прежнему зануляет новые элементы
+        Vector<int> v;
+        v.Resize(10);
+        assert(v[9] == 0);
+        v.Resize(20, default_init);
+        assert(v.Size() == 20);
+        assert(v[9] == 0);
+    }
+}
+
+void TestSnapshot() {
+    {
+        // Публикация из rvalue забирает буфер без копирования элементов
+        Obj::ResetCounters();
+        Vector<Obj> v(10);
+        v[0].id = 42;
+        const Obj* old_data = v.data();
+        const int old_copied = Obj::num_copied;
+        auto snap = std::move(v).MakeSnapshot();
+        assert(snap.Size() == 10);
+        assert(snap.begin() == old_data);
+        assert(snap[0].id == 42);
+        assert(Obj::num_copied == old_copied);
+
+        // Копии снимка разделяют буфер: O(1) на читателя
+        auto reader1 = snap;
+        auto reader2 = snap;
+        assert(reader1.begin() == old_data);
+        assert(reader2.begin() == old_data);
+        assert(Obj::num_copied == old_copied);
+
+        // Клонирование при первой записи: глубокая копия делается только тут
+        Vector<Obj> mutable_copy = reader1.ToVector();
+        assert(Obj::num_copied == old_copied + 10);
+        mutable_copy[0].id = 7;
+        assert(reader2[0].id == 42);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Публикация из lvalue — одна копия; дальнейшие правки исходного
+        // вектора снимка не касаются
+        Vector<int> v;
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(i);
+        }
+        auto snap = v.MakeSnapshot();
+        v[0] = 100;
+        v.PushBack(5);
+        assert(snap.Size() == 5);
+        assert(snap[0] == 0);
+
+        // Снимок переживает исходный вектор
+        Vector<int>::Snapshot survivor;
         {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+            Vector<int> local;
+            local.PushBack(7);
+            survivor = std::move(local).MakeSnapshot();
         }
-        Dump();
-    } catch (...) {
+        assert(survivor.Size() == 1);
+        assert(survivor[0] == 7);
     }
-    try {
-        const size_t NUM = 10;
-        C c;
+}
+
+void TestReleaseAdoptBuffer() {
+    {
+        // Полный круг: буфер уходит на I/O-границу и возвращается обратно
+        // без единого копирования или перемещения элементов
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(16);
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        const Obj* old_data = v.data();
+        const int old_copied = Obj::num_copied;
+        const int old_moved = Obj::num_moved;
+
+        auto released = v.ReleaseBuffer();
+        assert(released.buffer == old_data);
+        assert(released.size == 10);
+        assert(released.capacity == 16);
+        assert(v.Size() == 0);
+        assert(v.Capacity() == 0);
+        assert(v.data() == nullptr);
+        // Элементы живы в отпущенном буфере
+        assert(Obj::GetAliveObjectCount() == 10);
+
+        auto adopted = Vector<Obj>::AdoptBuffer(
+            released.buffer, released.size, released.capacity);
+        assert(adopted.Size() == 10);
+        assert(adopted.Capacity() == 16);
+        assert(adopted.data() == old_data);
+        assert(adopted[9].id == 9);
+        assert(Obj::num_copied == old_copied);
+        assert(Obj::num_moved == old_moved);
+
+        // Принявший вектор — полноценный: растёт и освобождает память сам
+        adopted.EmplaceBack(10);
+        assert(adopted.Size() == 11);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Отпущенный вектор остаётся пригодным к использованию
+        Vector<int> v;
+        v.PushBack(1);
+        auto released = v.ReleaseBuffer();
+        v.PushBack(2);
+        assert(v.Size() == 1 && v[0] == 2);
+        auto adopted = Vector<int>::AdoptBuffer(
+            released.buffer, released.size, released.capacity);
+        assert(adopted[0] == 1);
+    }
+}
+
+void TestClearTruncate() {
+    {
+        // Сценарий кадрового цикла: Clear сохраняет ёмкость, перезаливка
+        // того же объёма не выделяет память
+        using Alloc = CountingAllocator<int>;
+        Alloc::num_allocations = 0;
+        Vector<int, Alloc> v;
+        v.Reserve(1000);
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBackUnchecked(i);
+        }
+        const int* old_data = v.data();
+        v.Clear();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == 1000);
+        assert(v.data() == old_data);
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBackUnchecked(i);
+        }
+        assert(Alloc::num_allocations == 1);
+    }
+    {
+        // Truncate и PopBackN разрушают хвост одним проходом
+        Obj::ResetCounters();
+        Vector<Obj> v(10);
+        const int old_destroyed = Obj::num_destroyed;
+        v.Truncate(6);
+        assert(v.Size() == 6);
+        assert(v.Capacity() == 10);
+        assert(Obj::num_destroyed == old_destroyed + 4);
+        assert(Obj::GetAliveObjectCount() == 6);
+
+        v.PopBackN(2);
+        assert(v.Size() == 4);
+        assert(Obj::num_destroyed == old_destroyed + 6);
+
+        v.PopBackN(0);
+        assert(v.Size() == 4);
+
+        v.Clear();
+        assert(v.Size() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void TestGrowthPolicyAndShrink() {
+    {
+        // ShrinkToFit возвращает лишнюю ёмкость, сохраняя элементы
+        Obj::ResetCounters();
+        Vector<Obj> v(10);
+        v[9].id = 42;
+        v.Reserve(100);
+        assert(v.Capacity() == 100);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10);
+        assert(v.Size() == 10);
+        assert(v[9].id == 42);
+        assert(Obj::GetAliveObjectCount() == 10);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<int> v;
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+        v.PushBack(1);
+        v.Reserve(10);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 1);
+        assert(v[0] == 1);
+    }
+    {
+        // Политика роста 1.5x вместо удвоения
+        Vector<int, std::allocator<int>, GrowthPolicy1_5x> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+        }
+        // 1 -> 2 -> 3 -> 4 -> 6 -> 9 -> 13
+        assert(v.Capacity() == 13);
+        assert(v.Size() == 10);
+        assert(v[9] == 9);
+    }
+}
+
+void TestParallelResize() {
+    const size_t BIG = 300'000;
+    {
+        // Параллельное заполнение даёт тот же результат, что и обычное
+        Vector<int> v;
+        v.Resize(BIG, parallel);
+        assert(v.Size() == BIG);
+        assert(v[0] == 0 && v[BIG / 2] == 0 && v[BIG - 1] == 0);
+        for (size_t i = 0; i < BIG; ++i) {
+            v[i] = static_cast<int>(i);
+        }
+        // Параллельный Reserve переносит все элементы
+        v.Reserve(BIG * 2, parallel);
+        assert(v.Capacity() == BIG * 2);
+        assert(v[0] == 0 && v[BIG - 1] == static_cast<int>(BIG - 1));
+        // Уменьшение отдаёт работу обычному Resize
+        v.Resize(10, parallel);
+        assert(v.Size() == 10);
+    }
+    {
+        // Небольшой объём проходит по последовательной ветке
+        Vector<std::string> v;
+        v.Resize(100, parallel);
+        assert(v.Size() == 100);
+        assert(v[99].empty());
+    }
+}
+
+void TestEraseOperations() {
+    const size_t SIZE = 10;
+    {
+        // Диапазонный Erase сдвигает хвост один раз
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        const int old_move_assigned = Obj::num_move_assigned;
+        auto* pos = v.Erase(v.cbegin() + 2, v.cbegin() + 6);
+        assert(v.Size() == SIZE - 4);
+        assert(pos - v.begin() == 2);
+        assert(v[1].id == 1 && v[2].id == 6 && v[5].id == 9);
+        assert(Obj::num_move_assigned == old_move_assigned + 4);
+        assert(Obj::GetAliveObjectCount() == SIZE - 4);
+
+        // Пустой диапазон ничего не делает
+        auto* same = v.Erase(v.cbegin() + 1, v.cbegin() + 1);
+        assert(same - v.begin() == 1);
+        assert(v.Size() == SIZE - 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // EraseIf уплотняет за один проход
+        Vector<int> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        const size_t removed = v.EraseIf([](int x) {
+            return x % 2 == 0;
+        });
+        assert(removed == 50);
+        assert(v.Size() == 50);
+        assert(v[0] == 1 && v[49] == 99);
+    }
+    {
+        // UnorderedErase ставит последний элемент на место удалённого
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        auto* pos = v.UnorderedErase(v.cbegin() + 3);
+        assert(v.Size() == SIZE - 1);
+        assert(pos->id == static_cast<int>(SIZE - 1));
+        assert(Obj::num_move_assigned == 1);
+
+        // Удаление последнего элемента не требует перемещения
+        v.UnorderedErase(v.cbegin() + v.Size() - 1);
+        assert(v.Size() == SIZE - 2);
+        assert(Obj::num_move_assigned == 1);
+        assert(Obj::GetAliveObjectCount() == SIZE - 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void TestSmallVector() {
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, 4> v;
+        assert(v.IsInline());
+        assert(v.Capacity() == 4);
+        assert(v.Size() == 0);
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        // Пока элементы помещаются во встроенный буфер, кучи нет
+        assert(v.IsInline());
+        assert(Obj::num_moved == 0);
+        // Адрес первого элемента лежит внутри самого объекта
+        auto* obj_begin = reinterpret_cast<const char*>(&v);
+        auto* obj_end = obj_begin + sizeof(v);
+        auto* elem = reinterpret_cast<const char*>(&v[0]);
+        assert(elem >= obj_begin && elem < obj_end);
+
+        v.EmplaceBack(ID);
+        assert(!v.IsInline());
+        assert(v.Size() == 5);
+        assert(v.Capacity() == 8);
+        assert(v[4].id == ID);
+        assert(Obj::num_moved == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Перемещение из встроенного состояния переносит элементы поштучно
+        Obj::ResetCounters();
+        SmallVector<Obj, 4> v;
+        v.EmplaceBack(ID);
+        SmallVector<Obj, 4> moved(std::move(v));
+        assert(moved.Size() == 1);
+        assert(v.Size() == 0);
+        assert(moved[0].id == ID);
+        assert(Obj::num_moved == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Перемещение из кучи забирает буфер без переноса элементов
+        Obj::ResetCounters();
+        SmallVector<Obj, 2> v;
+        for (int i = 0; i < 5; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(!v.IsInline());
+        const int old_num_moved = Obj::num_moved;
+        const Obj* old_data = &v[0];
+        SmallVector<Obj, 2> moved(std::move(v));
+        assert(moved.Size() == 5);
+        assert(&moved[0] == old_data);
+        assert(Obj::num_moved == old_num_moved);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Swap между встроенным и кучевым состояниями
+        SmallVector<int, 4> inl;
+        inl.PushBack(1);
+        SmallVector<int, 4> heap;
+        for (int i = 0; i < 10; ++i) {
+            heap.PushBack(i);
+        }
+        inl.Swap(heap);
+        assert(inl.Size() == 10);
+        assert(inl[9] == 9);
+        assert(heap.Size() == 1);
+        assert(heap[0] == 1);
+        assert(heap.IsInline());
+    }
+}
+
+void TestConcurrentVector() {
+    {
+        // Несколько производителей пишут прямо в общий буфер, Seal отдаёт
+        // его обычному Vector без копирования
+        const size_t NUM_THREADS = 4;
+        const size_t PER_THREAD = 10'000;
+        ConcurrentVector<size_t> cv(NUM_THREADS * PER_THREAD);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < NUM_THREADS; ++t) {
+            workers.emplace_back([&cv, t] {
+                for (size_t i = 0; i < PER_THREAD; ++i) {
+                    const bool ok = cv.TryPushBack(t * PER_THREAD + i);
+                    assert(ok);
+                    (void)ok;
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        assert(cv.Size() == NUM_THREADS * PER_THREAD);
+
+        // Каждое значение попало в буфер ровно один раз
+        Vector<size_t> v = cv.Seal();
+        assert(v.Size() == NUM_THREADS * PER_THREAD);
+        std::vector<char> seen(v.Size(), 0);
+        for (size_t x : v) {
+            assert(x < seen.size() && !seen[x]);
+            seen[x] = 1;
+        }
+    }
+    {
+        // Seal сохраняет адрес буфера и все элементы
+        ConcurrentVector<int> cv(100);
+        for (int i = 0; i < 100; ++i) {
+            assert(cv.TryEmplaceBack(i) != nullptr);
+        }
+        // Переполнение не трогает буфер, а сигнализирует отказом
+        assert(!cv.TryPushBack(999));
+
+        Vector<int> v = cv.Seal();
+        assert(v.Size() == 100);
+        assert(v.Capacity() == 100);
+        long long sum = 0;
+        for (int x : v) {
+            sum += x;
+        }
+        assert(sum == 99 * 100 / 2);
+        // Контейнер после Seal пуст и больше не принимает элементы
+        assert(cv.Size() == 0 && cv.Capacity() == 0);
+        assert(!cv.TryPushBack(1));
+    }
+}
+
+void TestSegmentedVector() {
+    {
+        // Рост добавляет блоки и не перемещает существующие элементы
+        Obj::ResetCounters();
+        SegmentedVector<Obj, 8> v;
+        v.EmplaceBack(1);
+        const Obj* first = &v[0];
+        const int old_num_moved = Obj::num_moved;
+        for (int i = 2; i <= 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.Size() == 100);
+        assert(v.Capacity() == 104);  // 13 блоков по 8
+        assert(&v[0] == first);
+        assert(Obj::num_moved == old_num_moved);
+        assert(v[0].id == 1 && v[7].id == 8 && v[8].id == 9 && v[99].id == 100);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // PopBack и Clear оставляют блоки как запасную ёмкость
+        SegmentedVector<int, 8> v;
+        for (int i = 0; i < 20; ++i) {
+            v.PushBack(i);
+        }
+        v.PopBack();
+        assert(v.Size() == 19);
+        const size_t old_capacity = v.Capacity();
+        v.Clear();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == old_capacity);
+    }
+    {
+        // Копия независима от оригинала
+        SegmentedVector<Obj, 8> v;
+        for (int i = 0; i < 30; ++i) {
+            v.EmplaceBack(i);
+        }
+        SegmentedVector<Obj, 8> copy(v);
+        assert(copy.Size() == 30);
+        copy[0].id = 777;
+        assert(v[0].id == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Flatten собирает блоки в непрерывный Vector перемещением
+        Obj::ResetCounters();
+        SegmentedVector<Obj, 8> v;
+        for (int i = 0; i < 50; ++i) {
+            v.EmplaceBack(i);
+        }
+        const int old_num_copied = Obj::num_copied;
+        Vector<Obj> flat = v.Flatten();
+        assert(flat.Size() == 50);
+        assert(flat.Capacity() == 50);
+        assert(Obj::num_copied == old_num_copied);
+        for (int i = 0; i < 50; ++i) {
+            assert(flat[i].id == i);
+        }
+        assert(v.Size() == 0 && v.Capacity() == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+#if defined(__linux__)
+void TestMmapAllocator() {
+    using MmapVector = Vector<uint64_t, MmapAllocator<uint64_t>>;
+    {
+        // Страницы коммитятся лениво, поэтому большой Reserve безопасен и дёшев
+        MmapVector v;
+        v.Reserve(1'000'000);
+        assert(v.Capacity() == 1'000'000);
+        // mmap выравнивает буфер по границе страницы
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % 4096 == 0);
+        for (uint64_t i = 0; i < 1000; ++i) {
+            v.PushBack(i * i);
+        }
+        assert(v.Size() == 1000);
+        assert(v[999] == 999u * 999u);
+    }
+    {
+        // Рост идёт через mremap: содержимое сохраняется без поэлементного переноса
+        MmapVector v;
+        for (uint64_t i = 0; i < 10'000; ++i) {
+            v.PushBack(i);
+        }
+        v.Reserve(100'000);
+        for (uint64_t i = 0; i < 10'000; ++i) {
+            assert(v[i] == i);
+        }
+    }
+}
+
+void TestSnapshotPersistence() {
+    const char* PATH = "/tmp/advanced_vector_snapshot_test.bin";
+    const size_t SIZE = 100'000;
+    {
+        // Сохранение и zero-copy загрузка через отображение файла
+        Vector<uint64_t> v;
+        v.Reserve(SIZE);
+        for (uint64_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i * 3);
+        }
+        assert(v.SaveTo(PATH));
+
+        Vector<uint64_t, FileMappingAllocator<uint64_t>> loaded;
+        assert(LoadVectorSnapshot(PATH, loaded));
+        assert(loaded.Size() == SIZE);
+        assert(loaded.Capacity() == SIZE);
+        // Данные отображены со смещения, кратного странице
+        assert(reinterpret_cast<uintptr_t>(loaded.begin()) % 4096 == 0);
+        assert(loaded[0] == 0 && loaded[1] == 3 && loaded[SIZE - 1] == (SIZE - 1) * 3);
+
+        // MAP_PRIVATE: запись в элемент копирует страницу, файл не меняется
+        loaded[0] = 777;
+        assert(loaded[0] == 777);
+
+        Vector<uint64_t, FileMappingAllocator<uint64_t>> reloaded;
+        assert(LoadVectorSnapshot(PATH, reloaded));
+        assert(reloaded[0] == 0);
+
+        // Рост загруженного вектора уводит данные в анонимную память
+        loaded.PushBack(42);
+        assert(loaded.Size() == SIZE + 1);
+        assert(loaded[0] == 777 && loaded[SIZE] == 42);
+    }
+    {
+        // Заголовок защищает от загрузки под другим типом элементов
+        Vector<uint32_t, FileMappingAllocator<uint32_t>> wrong;
+        assert(!LoadVectorSnapshot(PATH, wrong));
+        Vector<uint64_t, FileMappingAllocator<uint64_t>> missing;
+        assert(!LoadVectorSnapshot("/tmp/advanced_vector_no_such_snapshot.bin", missing));
+    }
+    {
+        // Оборванный снимок (короче, чем обещает заголовок) отклоняется,
+        // а не умирает с SIGBUS при первом обращении к элементам
+        Vector<uint64_t> v;
+        v.Resize(1000);
+        assert(v.SaveTo(PATH));
+        assert(truncate(PATH, 4096 + 500 * sizeof(uint64_t)) == 0);
+        Vector<uint64_t, FileMappingAllocator<uint64_t>> loaded;
+        assert(!LoadVectorSnapshot(PATH, loaded));
+    }
+    {
+        // Испорченный заголовок: element_count настолько велик, что
+        // count * sizeof(T) переполняется — проверку размера файла это
+        // обойти не должно
+        Vector<uint64_t> v;
+        v.Resize(16);
+        assert(v.SaveTo(PATH));
+        const int fd = open(PATH, O_WRONLY);
+        assert(fd >= 0);
+        const uint64_t bogus_count = (uint64_t{1} << 61) + 1;
+        assert(pwrite(fd, &bogus_count, sizeof(bogus_count),
+            offsetof(VectorSnapshotHeader, element_count)) == sizeof(bogus_count));
+        close(fd);
+        Vector<uint64_t, FileMappingAllocator<uint64_t>> loaded;
+        assert(!LoadVectorSnapshot(PATH, loaded));
+    }
+    {
+        // Пустой вектор: валидный снимок без байтов данных
+        Vector<uint64_t> empty;
+        assert(empty.SaveTo(PATH));
+        Vector<uint64_t, FileMappingAllocator<uint64_t>> loaded;
+        assert(LoadVectorSnapshot(PATH, loaded));
+        assert(loaded.Size() == 0);
+    }
+    std::remove(PATH);
+}
+#endif
+
+#ifdef ADVANCED_VECTOR_STATS
+void TestStats() {
+    // Счётчики экземпляра: переезды буфера, пиковая ёмкость, перенесённые байты
+    {
+        Vector<int> v;
+        assert(v.GetStats().reallocations == 0);
+        size_t expected_bytes = 0;
+        for (int i = 0; i < 100; ++i) {
+            if (v.Size() == v.Capacity()) {
+                expected_bytes += v.Size() * sizeof(int);
+            }
+            v.PushBack(i);
+        }
+        // Рост 1 -> 2 -> 4 -> ... -> 128: восемь переездов
+        assert(v.GetStats().reallocations == 8);
+        assert(v.GetStats().peak_capacity == 128);
+        assert(v.GetStats().bytes_relocated == expected_bytes);
+    }
+    // Глобальные хуки вызываются из RawMemory::Allocate/Deallocate
+    {
+        static size_t allocated_bytes;
+        static size_t deallocated_bytes;
+        allocated_bytes = 0;
+        deallocated_bytes = 0;
+        VectorStatsHooks::on_allocate = [](size_t bytes) {
+            allocated_bytes += bytes;
+        };
+        VectorStatsHooks::on_deallocate = [](size_t bytes) {
+            deallocated_bytes += bytes;
+        };
+        {
+            Vector<int> v;
+            v.Reserve(10);
+            v.Reserve(20);
+            assert(allocated_bytes == 30 * sizeof(int));
+            assert(deallocated_bytes == 10 * sizeof(int));
+        }
+        assert(deallocated_bytes == 30 * sizeof(int));
+        VectorStatsHooks::on_allocate = nullptr;
+        VectorStatsHooks::on_deallocate = nullptr;
+    }
+    // Рост на месте через reallocate виден хукам и счётчикам экземпляра:
+    // байты выделений и освобождений сходятся, переезд учтён с нулём байт
+    {
+        static size_t allocated_bytes;
+        static size_t deallocated_bytes;
+        allocated_bytes = 0;
+        deallocated_bytes = 0;
+        VectorStatsHooks::on_allocate = [](size_t bytes) {
+            allocated_bytes += bytes;
+        };
+        VectorStatsHooks::on_deallocate = [](size_t bytes) {
+            deallocated_bytes += bytes;
+        };
         {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+            Vector<int, ReallocAllocator<int>> v;
+            v.PushBack(1);
+            const size_t reallocations_before = v.GetStats().reallocations;
+            const size_t relocated_before = v.GetStats().bytes_relocated;
+            v.Reserve(1000);
+            assert(v.GetStats().reallocations == reallocations_before + 1);
+            assert(v.GetStats().peak_capacity == 1000);
+            assert(v.GetStats().bytes_relocated == relocated_before);
+            assert(allocated_bytes == deallocated_bytes + 1000 * sizeof(int));
         }
-        Dump();
-    } catch (...) {
+        assert(allocated_bytes == deallocated_bytes);
+        VectorStatsHooks::on_allocate = nullptr;
+        VectorStatsHooks::on_deallocate = nullptr;
     }
 }
+#endif
+
+#ifdef ADVANCED_VECTOR_CAPACITY_PROFILE
+void TestCapacityProfile() {
+    CapacityProfiler::Instance().Reset();
+    {
+        // Сайт 1 хронически недорезервирует: каждый запрос растит буфер с нуля
+        for (int run = 0; run < 3; ++run) {
+            Vector<int> v;
+            v.ProfileAs(1);
+            for (int i = 0; i < 100; ++i) {
+                v.PushBack(i);
+            }
+        }
+        // Сайт 2 наоборот: резервирует на порядки больше, чем использует
+        Vector<int> v;
+        v.ProfileAs(2);
+        v.Reserve(1000);
+        v.PushBack(42);
+    }
+
+    const auto site1 = CapacityProfiler::Instance().GetSite(1);
+    assert(site1.vectors == 3);
+    // Рост 0 -> 100 удвоением — по 8 переездов на каждый экземпляр
+    assert(site1.reallocations == 3 * 8);
+    assert(site1.max_final_size == 100);
+    assert(CapacityProfiler::Instance().RecommendedReserve(1) == 100);
+
+    const auto site2 = CapacityProfiler::Instance().GetSite(2);
+    assert(site2.vectors == 1);
+    assert(site2.max_final_size == 1);
+    assert(site2.max_peak_capacity == 1000);
+
+    std::ostringstream report;
+    CapacityProfiler::Instance().Report(report);
+    const std::string text = report.str();
+    assert(text.find("site 1") != std::string::npos);
+    assert(text.find("recommended Reserve(100)") != std::string::npos);
+    assert(text.find("перерезервирование") != std::string::npos);
+
+    CapacityProfiler::Instance().Reset();
+    assert(CapacityProfiler::Instance().GetSite(1).vectors == 0);
+}
+#endif
 
 int main() {
     try {
@@ -648,7 +1832,37 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        TestAllocatorAware();
+        TestReallocExtend();
+        TestAlignedAllocator();
+        TestRangeOperations();
+        TestInsertN();
+        TestAssign();
+        TestUncheckedPushBack();
+        TestTryApi();
+        TestTriviallyRelocatable();
+        TestStdInterface();
+        TestStreamingFill();
+        TestDefaultInitResize();
+        TestSnapshot();
+        TestReleaseAdoptBuffer();
+        TestClearTruncate();
+        TestGrowthPolicyAndShrink();
+        TestEraseOperations();
+        TestParallelResize();
+        TestSmallVector();
+        TestConcurrentVector();
+        TestSegmentedVector();
+#if defined(__linux__)
+        TestMmapAllocator();
+        TestSnapshotPersistence();
+#endif
+#ifdef ADVANCED_VECTOR_STATS
+        TestStats();
+#endif
+#ifdef ADVANCED_VECTOR_CAPACITY_PROFILE
+        TestCapacityProfile();
+#endif
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
@@ -0,0 +1,183 @@
+#pragma once
+#include "vector.h"
+
+#include <vector>
+
+// SegmentedVector — хранилище для гигантских векторов, которым переезд
+// буфера при росте обходится слишком дорого: каждый Reserve у обычного
+// Vector перемещает все элементы и на время переезда удерживает старый
+// и новый буферы одновременно. Здесь рост добавляет блок фиксированного
+// размера в таблицу блоков и никогда не трогает уже построенные
+// элементы: худший случай EmplaceBack — O(1), адреса элементов
+// стабильны, пикового удвоения памяти нет. Плата — чуть более дорогой
+// operator[] (сдвиг и маска вместо одного сложения) и отсутствие
+// непрерывности; Flatten() собирает содержимое обратно в обычный Vector
+template <typename T, size_t BlockElements = 4096, typename Alloc = std::allocator<T>>
+class SegmentedVector {
+    static_assert(BlockElements > 0 && (BlockElements & (BlockElements - 1)) == 0,
+        "размер блока должен быть степенью двойки: индексация идёт сдвигом и маской");
+
+public:
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Alloc& alloc)
+        : alloc_(alloc) {
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+        : alloc_(other.alloc_) {
+        blocks_.reserve(other.blocks_.size());
+        ADVANCED_VECTOR_TRY {
+            size_t remaining = other.size_;
+            for (const auto& block : other.blocks_) {
+                blocks_.emplace_back(BlockElements, alloc_);
+                const size_t batch = std::min(remaining, BlockElements);
+                detail::UninitializedCopyN(block.GetAddress(), batch,
+                    blocks_.back().GetAddress());
+                size_ += batch;
+                remaining -= batch;
+            }
+        } ADVANCED_VECTOR_CATCH_ALL {
+            DestroyElements();
+            ADVANCED_VECTOR_RETHROW;
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , blocks_(std::move(other.blocks_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            SegmentedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            DestroyElements();
+            alloc_ = std::move(rhs.alloc_);
+            blocks_ = std::move(rhs.blocks_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        DestroyElements();
+    }
+
+    void Swap(SegmentedVector& other) noexcept {
+        std::swap(alloc_, other.alloc_);
+        blocks_.swap(other.blocks_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return blocks_.size() * BlockElements;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_VERIFY(index < size_);
+        return *Address(index);
+    }
+
+    void PushBack(const T& value) {
+        (void)EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        (void)EmplaceBack(std::move(value));
+    }
+
+    // Добавляет элемент в конец. Рост — это emplace_back в таблицу блоков:
+    // уже построенные элементы не перемещаются ни при каком размере
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            blocks_.emplace_back(BlockElements, alloc_);
+        }
+        T* slot = Address(size_);
+        detail::ConstructAt(slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    // Последний блок не освобождается и остаётся запасной ёмкостью
+    void PopBack() noexcept {
+        assert(size_);
+        std::destroy_at(Address(size_ - 1));
+        --size_;
+    }
+
+    // Разрушает элементы, блоки остаются как ёмкость — как Clear у Vector
+    void Clear() noexcept {
+        DestroyElements();
+        size_ = 0;
+    }
+
+    // Собирает элементы в непрерывный Vector за один O(n) проход — ту же
+    // цену стоил бы один переезд буфера. Контейнер остаётся пустым,
+    // блоки освобождаются
+    Vector<T, Alloc> Flatten() {
+        Vector<T, Alloc> flat(alloc_);
+        flat.Reserve(size_);
+        size_t remaining = size_;
+        for (auto& block : blocks_) {
+            const size_t batch = std::min(remaining, BlockElements);
+            T* from = block.GetAddress();
+            flat.AppendRange(std::make_move_iterator(from),
+                std::make_move_iterator(from + batch));
+            detail::DestroyN(from, batch);
+            remaining -= batch;
+        }
+        blocks_.clear();
+        size_ = 0;
+        return flat;
+    }
+
+private:
+    static constexpr size_t Log2(size_t x) noexcept {
+        size_t result = 0;
+        while (x > 1) {
+            x >>= 1;
+            ++result;
+        }
+        return result;
+    }
+
+    static constexpr size_t BLOCK_SHIFT = Log2(BlockElements);
+    static constexpr size_t BLOCK_MASK = BlockElements - 1;
+
+    T* Address(size_t index) noexcept {
+        return blocks_[index >> BLOCK_SHIFT].GetAddress() + (index & BLOCK_MASK);
+    }
+
+    void DestroyElements() noexcept {
+        size_t remaining = size_;
+        for (auto& block : blocks_) {
+            const size_t batch = std::min(remaining, BlockElements);
+            detail::DestroyN(block.GetAddress(), batch);
+            remaining -= batch;
+            if (remaining == 0) {
+                break;
+            }
+        }
+    }
+
+    Alloc alloc_;
+    std::vector<RawMemory<T, Alloc>> blocks_;
+    size_t size_ = 0;
+};
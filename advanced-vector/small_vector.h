@@ -0,0 +1,193 @@
+#pragma once
+#include "vector.h"
+
+// SmallVector хранит первые InlineCapacity элементов прямо внутри объекта
+// и обращается к куче только после того, как встроенный буфер заполнен.
+// Построен на той же машинерии RawMemory, что и Vector, поэтому после
+// "переезда" в кучу ведёт себя так же, как обычный Vector
+template <typename T, size_t InlineCapacity>
+class SmallVector {
+    static_assert(InlineCapacity > 0, "Для нулевой встроенной ёмкости используйте Vector");
+
+public:
+    SmallVector() = default;
+
+    explicit SmallVector(size_t size) {
+        Reserve(size);
+        std::uninitialized_value_construct_n(Data(), size);
+        size_ = size;
+    }
+
+    SmallVector(const SmallVector& other) {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.begin(), other.size_, Data());
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        MoveFrom(std::move(other));
+    }
+
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            SmallVector rhs_copy(rhs);
+            *this = std::move(rhs_copy);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            detail::DestroyN(Data(), size_);
+            size_ = 0;
+            MoveFrom(std::move(rhs));
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        detail::DestroyN(Data(), size_);
+    }
+
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        // Пока хотя бы одна из сторон хранит элементы во встроенном буфере,
+        // обменяться одними указателями нельзя — меняемся через перемещение
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? InlineCapacity : heap_.Capacity();
+    }
+
+    // true, пока элементы лежат во встроенном буфере объекта
+    bool IsInline() const noexcept {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    iterator begin() noexcept {
+        return Data();
+    }
+
+    iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    const_iterator begin() const noexcept {
+        return const_cast<SmallVector&>(*this).Data();
+    }
+
+    const_iterator end() const noexcept {
+        return begin() + size_;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T> new_data(new_capacity);
+        detail::RelocateN(Data(), size_, new_data.GetAddress());
+        detail::DestroyRelocatedN(Data(), size_);
+        heap_ = std::move(new_data);
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            detail::DestroyN(Data() + new_size, size_ - new_size);
+        }
+        else {
+            if (new_size > Capacity()) {
+                Reserve(new_size);
+            }
+            std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const T& value) {
+        (void)EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        (void)EmplaceBack(std::move(value));
+    }
+
+    void PopBack() {
+        assert(size_);
+        std::destroy_at(Data() + size_ - 1);
+        --size_;
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (Capacity() <= size_) {
+            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
+            new (new_data.GetAddress() + size_) T(std::forward<Args>(args)...);
+            ADVANCED_VECTOR_TRY {
+                detail::RelocateN(Data(), size_, new_data.GetAddress());
+            } ADVANCED_VECTOR_CATCH_ALL {
+                std::destroy_at(new_data + size_);
+                ADVANCED_VECTOR_RETHROW;
+            }
+            detail::DestroyRelocatedN(Data(), size_);
+            heap_ = std::move(new_data);
+        }
+        else {
+            new (Data() + size_) T(std::forward<Args>(args)...);
+        }
+        return Data()[size_++];
+    }
+
+private:
+    T* Data() noexcept {
+        return IsInline() ? InlineData() : heap_.GetAddress();
+    }
+
+    T* InlineData() noexcept {
+        return reinterpret_cast<T*>(inline_buf_);
+    }
+
+    // Предполагает, что *this пуст. Буфер в куче забирается указателем,
+    // встроенные элементы переносятся поштучно, источник остаётся пустым
+    void MoveFrom(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (!other.IsInline()) {
+            heap_ = std::move(other.heap_);
+            size_ = std::exchange(other.size_, 0);
+        }
+        else {
+            std::uninitialized_move_n(other.Data(), other.size_, Data());
+            size_ = other.size_;
+            detail::DestroyN(other.Data(), other.size_);
+            other.size_ = 0;
+        }
+    }
+
+    alignas(T) unsigned char inline_buf_[InlineCapacity * sizeof(T)];
+    RawMemory<T> heap_;
+    size_t size_ = 0;
+};
@@ -1,127 +1,1008 @@
 #pragma once
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <new>
+#include <thread>
 #include <utility>
 #include <memory>
 #include <iterator>
+#include <type_traits>
+#include <vector>
 
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Порог в байтах, начиная с которого большие тривиальные заполнения и
+// копирования идут non-temporal записями мимо кеша: гигантский Resize
+// перестаёт вытеснять рабочее множество соседних вычислений. Можно
+// переопределить до включения заголовка
+#ifndef ADVANCED_VECTOR_STREAM_THRESHOLD
+#define ADVANCED_VECTOR_STREAM_THRESHOLD (4 * 1024 * 1024)
+#endif
+
+// Аннотации непрерывных контейнеров AddressSanitizer. Включаются макросом
+// ADVANCED_VECTOR_ASAN в canary-сборках с -fsanitize=address
+#ifdef ADVANCED_VECTOR_ASAN
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+// Агрегатору профилирования ёмкости нужны контейнер сайтов и вывод отчёта
+#ifdef ADVANCED_VECTOR_CAPACITY_PROFILE
+#include <map>
+#include <mutex>
+#include <ostream>
+#endif
+
+// constexpr-поддержка контейнера требует C++20: динамическое выделение
+// и construct_at в constant evaluation. В C++17 макрос раскрывается в пустоту,
+// и заголовок компилируется как раньше
+#if defined(__cpp_lib_constexpr_dynamic_alloc) && defined(__cpp_lib_is_constant_evaluated)
+#define ADVANCED_VECTOR_CONSTEXPR constexpr
+#define ADVANCED_VECTOR_HAS_CONSTEXPR 1
+#else
+#define ADVANCED_VECTOR_CONSTEXPR
+#define ADVANCED_VECTOR_HAS_CONSTEXPR 0
+#endif
+
+// Поддержка сборок с -fno-exceptions: try/catch раскрывается в обычный
+// if, а точки "перебросить дальше" — в завершение процесса. Контракт при
+// выключенных исключениях: неудача выделения завершает процесс
+// (terminate-on-OOM), для мягкой обработки есть TryReserve/TryPushBack
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define ADVANCED_VECTOR_HAS_EXCEPTIONS 1
+#define ADVANCED_VECTOR_TRY try
+#define ADVANCED_VECTOR_CATCH_ALL catch (...)
+#define ADVANCED_VECTOR_RETHROW throw
+#define ADVANCED_VECTOR_THROW_BAD_ALLOC throw std::bad_alloc {}
+#else
+#define ADVANCED_VECTOR_HAS_EXCEPTIONS 0
+#define ADVANCED_VECTOR_TRY if (true)
+#define ADVANCED_VECTOR_CATCH_ALL else if (false)
+#define ADVANCED_VECTOR_RETHROW std::terminate()
+#define ADVANCED_VECTOR_THROW_BAD_ALLOC std::terminate()
+#endif
+
+// Проверка индексов: в отладочной сборке — обычный assert, в релизе не
+// порождает ветвления, а превращается в подсказку оптимизатору, что
+// условие истинно (нарушение и так было неопределённым поведением)
+#if !defined(NDEBUG)
+#define ADVANCED_VECTOR_VERIFY(cond) assert(cond)
+#elif defined(__GNUC__) || defined(__clang__)
+#define ADVANCED_VECTOR_VERIFY(cond) ((cond) ? void(0) : __builtin_unreachable())
+#elif defined(_MSC_VER)
+#define ADVANCED_VECTOR_VERIFY(cond) __assume(cond)
+#else
+#define ADVANCED_VECTOR_VERIFY(cond) ((void)0)
+#endif
+
+// Запрещает встраивание холодных путей (рост буфера), чтобы они не
+// раздували горячие циклы вставки
+#if defined(__GNUC__) || defined(__clang__)
+#define ADVANCED_VECTOR_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define ADVANCED_VECTOR_NOINLINE __declspec(noinline)
+#else
+#define ADVANCED_VECTOR_NOINLINE
+#endif
+
+// Признак "тривиально перемещаемого" типа: перемещающее конструирование
+// плюс разрушение источника эквивалентны побайтовому копированию. По
+// умолчанию выводится из тривиальной копируемости; для своих типов
+// (хэндлы, обёртки над указателями без самоссылок) признак можно
+// специализировать, и тогда рост буфера пойдёт одним bulk-memcpy без
+// поэлементных перемещений и прохода деструкторов по старому буферу
+template <typename T>
+struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+namespace detail {
+
+// Конструирует объект в сырой памяти; в constant evaluation использует
+// std::construct_at вместо размещающего new
+template <typename T, typename... Args>
+ADVANCED_VECTOR_CONSTEXPR T* ConstructAt(T* p, Args&&... args) {
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+    return std::construct_at(p, std::forward<Args>(args)...);
+#else
+    return ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+#endif
+}
+
+// Переносит count элементов из сырой памяти from в сырую память to.
+// Для тривиально перемещаемых типов буфер переносится одним memcpy,
+// иначе используется перемещение либо копирование (если перемещение может бросить)
 template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void RelocateN(T* from, size_t count, T* to) {
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i != count; ++i) {
+            std::construct_at(to + i, std::move(from[i]));
+        }
+        return;
+    }
+#endif
+    if constexpr (IsTriviallyRelocatable<T>::value) {
+        // memcpy с нулевым count и нулевым указателем (пустой вектор) — UB,
+        // из-за которого оптимизатор вправе счесть указатели ненулевыми
+        if (count != 0) {
+            std::memcpy(static_cast<void*>(to), from, count * sizeof(T));
+        }
+    }
+    else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+        std::uninitialized_move_n(from, count, to);
+    }
+    else {
+        std::uninitialized_copy_n(from, count, to);
+    }
+}
+
+// Разрушает count элементов; для тривиально разрушаемых типов не делает ничего
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void DestroyN(T* buf, size_t count) noexcept {
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+    if (std::is_constant_evaluated()) {
+        std::destroy_n(buf, count);
+        return;
+    }
+#endif
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        std::destroy_n(buf, count);
+    }
+}
+
+// Разрушает источники после RelocateN. Для тривиально перемещаемых типов
+// их байты уже живут в новом буфере, и деструкторы вызывать нельзя;
+// в constant evaluation RelocateN переносит поэлементно, и источники
+// разрушаются как обычно
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void DestroyRelocatedN(T* buf, size_t count) noexcept {
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+    if (std::is_constant_evaluated()) {
+        std::destroy_n(buf, count);
+        return;
+    }
+#endif
+    if constexpr (!IsTriviallyRelocatable<T>::value) {
+        std::destroy_n(buf, count);
+    }
+    else {
+        (void)buf;
+        (void)count;
+    }
+}
+
+#if defined(__SSE2__)
+// true, если элементы типа T можно писать 16-байтными non-temporal
+// блоками: тип тривиально копируем, а его размер делит 16, так что
+// повторённый паттерн значения заполняет блок целиком
+template <typename T>
+inline constexpr bool IsStreamable =
+    std::is_trivially_copyable_v<T> && sizeof(T) <= 16 && 16 % sizeof(T) == 0;
+
+// Заполняет count элементов копиями value записями мимо кеша
+// (_mm_stream_si128). Голова до 16-байтной границы и неполный хвост
+// пишутся обычным образом; в конце — sfence, чтобы записи стали видимы
+// другим потокам до того, как буфер уйдёт потребителю
+template <typename T>
+void StreamFillN(T* to, size_t count, const T& value) {
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(to);
+    const size_t head_bytes = (16 - addr % 16) % 16;
+    if (head_bytes % sizeof(T) != 0) {
+        // Выравнивание буфера не кратно размеру элемента — паттерн в блоке
+        // собьётся, пишем целиком обычным способом
+        std::uninitialized_fill_n(to, count, value);
+        return;
+    }
+
+    const size_t head = std::min(count, head_bytes / sizeof(T));
+    std::uninitialized_fill_n(to, head, value);
+
+    unsigned char raw[16];
+    for (size_t i = 0; i != 16 / sizeof(T); ++i) {
+        std::memcpy(raw + i * sizeof(T), &value, sizeof(T));
+    }
+    __m128i pattern;
+    std::memcpy(&pattern, raw, 16);
+
+    const size_t blocks = (count - head) * sizeof(T) / 16;
+    __m128i* dst = reinterpret_cast<__m128i*>(to + head);
+    for (size_t i = 0; i != blocks; ++i) {
+        _mm_stream_si128(dst + i, pattern);
+    }
+    _mm_sfence();
+
+    const size_t streamed = head + blocks * (16 / sizeof(T));
+    std::uninitialized_fill_n(to + streamed, count - streamed, value);
+}
+
+// Копирует count элементов: источник читается через кеш, приёмник
+// пишется non-temporal записями. Для гигантских копий (конструктор
+// копирования, реаллокация) приёмник всё равно не будет прочитан
+// в ближайшее время, и держать его в кеше незачем
+template <typename T>
+void StreamCopyN(const T* from, size_t count, T* to) {
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(to);
+    const size_t head_bytes = (16 - addr % 16) % 16;
+    if (head_bytes % sizeof(T) != 0) {
+        std::memcpy(static_cast<void*>(to), from, count * sizeof(T));
+        return;
+    }
+
+    const size_t head = std::min(count, head_bytes / sizeof(T));
+    std::memcpy(static_cast<void*>(to), from, head * sizeof(T));
+
+    const size_t blocks = (count - head) * sizeof(T) / 16;
+    __m128i* dst = reinterpret_cast<__m128i*>(to + head);
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(from + head);
+    for (size_t i = 0; i != blocks; ++i) {
+        __m128i chunk;
+        std::memcpy(&chunk, src + i * 16, 16);
+        _mm_stream_si128(dst + i, chunk);
+    }
+    _mm_sfence();
+
+    const size_t streamed = head + blocks * (16 / sizeof(T));
+    std::memcpy(static_cast<void*>(to + streamed), from + streamed,
+        (count - streamed) * sizeof(T));
+}
+#endif  // __SSE2__
+
+// Копирует count элементов в сырую память, одним memcpy для тривиально
+// копируемых типов
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void UninitializedCopyN(const T* from, size_t count, T* to) {
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i != count; ++i) {
+            std::construct_at(to + i, from[i]);
+        }
+        return;
+    }
+#endif
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (count != 0) {
+#if defined(__SSE2__)
+            if constexpr (IsStreamable<T>) {
+                if (count * sizeof(T) >= ADVANCED_VECTOR_STREAM_THRESHOLD) {
+                    StreamCopyN(from, count, to);
+                    return;
+                }
+            }
+#endif
+            std::memcpy(static_cast<void*>(to), from, count * sizeof(T));
+        }
+    }
+    else {
+        std::uninitialized_copy_n(from, count, to);
+    }
+}
+
+
+// Заполняет сырую память count копиями value; очень большие тривиальные
+// заполнения идут потоковыми записями мимо кеша
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void UninitializedFillN(T* to, size_t count, const T& value) {
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i != count; ++i) {
+            std::construct_at(to + i, value);
+        }
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    if constexpr (IsStreamable<T>) {
+        if (count * sizeof(T) >= ADVANCED_VECTOR_STREAM_THRESHOLD) {
+            StreamFillN(to, count, value);
+            return;
+        }
+    }
+#endif
+    std::uninitialized_fill_n(to, count, value);
+}
+
+// Конструирует count элементов со значением по умолчанию
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void ValueConstructN(T* buf, size_t count) {
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i != count; ++i) {
+            std::construct_at(buf + i);
+        }
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    // Для тривиальных типов value-инициализация — это заполнение нулями,
+    // и огромный хвост выгоднее писать мимо кеша
+    if constexpr (IsStreamable<T> && std::is_trivially_default_constructible_v<T>) {
+        if (count * sizeof(T) >= ADVANCED_VECTOR_STREAM_THRESHOLD) {
+            StreamFillN(buf, count, T());
+            return;
+        }
+    }
+#endif
+    std::uninitialized_value_construct_n(buf, count);
+}
+
+// Минимальный объём работы на поток: мелкие операции выполняются
+// последовательно, иначе накладные расходы на потоки съедают выигрыш
+inline constexpr size_t PARALLEL_MIN_CHUNK = 64 * 1024;
+
+// Режет [0, count) на чанки и выполняет fn(from, to) на нескольких потоках.
+// Для малых count или одноядерных машин работает последовательно.
+// fn не должна бросать исключения
+template <typename Fn>
+void ParallelFor(size_t count, Fn fn) {
+    const size_t hw = std::thread::hardware_concurrency();
+    if (hw < 2 || count < PARALLEL_MIN_CHUNK * 2) {
+        fn(size_t{0}, count);
+        return;
+    }
+    const size_t num_threads = std::min<size_t>(hw, count / PARALLEL_MIN_CHUNK);
+    const size_t chunk = count / num_threads;
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (size_t i = 0; i + 1 < num_threads; ++i) {
+        workers.emplace_back(fn, i * chunk, (i + 1) * chunk);
+    }
+    // Последний (самый длинный) чанк выполняем на вызывающем потоке
+    fn((num_threads - 1) * chunk, count);
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+// true, если аллокатор предоставляет расширение reallocate(ptr, old_n, new_n)
+template <typename Alloc, typename T, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Alloc, typename T>
+struct HasReallocate<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<T*>(), size_t{}, size_t{}))>> : std::true_type {};
+
+}  // namespace detail
+
+// Аллокатор поверх malloc/realloc/free. В отличие от std::allocator умеет
+// расширять уже выделенный блок (часто — на месте, без переноса байтов),
+// чем пользуется Vector при росте буфера тривиально копируемых типов
+template <typename T>
+struct ReallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+        "malloc не гарантирует выравнивание строже max_align_t");
+
+    using value_type = T;
+
+    ReallocAllocator() = default;
+
+    template <typename U>
+    ReallocAllocator(const ReallocAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        void* p = std::malloc(n * sizeof(T));
+        if (p == nullptr) {
+            ADVANCED_VECTOR_THROW_BAD_ALLOC;
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        std::free(p);
+    }
+
+    // Расширяет блок до new_n элементов. Байты при необходимости переносит
+    // сам realloc, поэтому годится только для тривиально копируемых типов
+    T* reallocate(T* p, size_t /*old_n*/, size_t new_n) {
+        void* q = std::realloc(p, new_n * sizeof(T));
+        if (q == nullptr) {
+            ADVANCED_VECTOR_THROW_BAD_ALLOC;
+        }
+        return static_cast<T*>(q);
+    }
+
+    bool operator==(const ReallocAllocator&) const noexcept {
+        return true;
+    }
+
+    bool operator!=(const ReallocAllocator&) const noexcept {
+        return false;
+    }
+};
+
+#if defined(__linux__)
+// Аллокатор поверх анонимного mmap. Ядро резервирует только адресное
+// пространство, а физические страницы выделяет лениво при первой записи,
+// поэтому Reserve на гигабайты не стоит памяти, пока буфер реально не
+// заполнен. Для блоков от HUGE_PAGE_THRESHOLD байт запрашиваются прозрачные
+// огромные страницы (MADV_HUGEPAGE) — меньше промахов TLB при сканировании.
+// Метод reallocate реализован через mremap, так что RawMemory::TryExtend
+// расширяет отображение без переноса элементов (или ядро переносит страницы
+// переназначением, не копируя байты)
+template <typename T>
+struct MmapAllocator {
+    static_assert(alignof(T) <= 4096, "mmap выравнивает блоки по границе страницы");
+
+    using value_type = T;
+
+    // Начиная с этого размера блока просим ядро использовать огромные страницы
+    static constexpr size_t HUGE_PAGE_THRESHOLD = 2u * 1024 * 1024;
+
+    MmapAllocator() = default;
+
+    template <typename U>
+    MmapAllocator(const MmapAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        const size_t bytes = n * sizeof(T);
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            ADVANCED_VECTOR_THROW_BAD_ALLOC;
+        }
+        RequestHugePages(p, bytes);
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        munmap(p, n * sizeof(T));
+    }
+
+    // Расширяет отображение до new_n элементов. Как и realloc, может вернуть
+    // другой адрес, поэтому годится только для тривиально копируемых типов
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        void* q = mremap(p, old_n * sizeof(T), new_n * sizeof(T), MREMAP_MAYMOVE);
+        if (q == MAP_FAILED) {
+            ADVANCED_VECTOR_THROW_BAD_ALLOC;
+        }
+        RequestHugePages(q, new_n * sizeof(T));
+        return static_cast<T*>(q);
+    }
+
+    bool operator==(const MmapAllocator&) const noexcept {
+        return true;
+    }
+
+    bool operator!=(const MmapAllocator&) const noexcept {
+        return false;
+    }
+
+private:
+    // madvise — лишь подсказка, её отказ (например, THP выключены) не ошибка
+    static void RequestHugePages(void* p, size_t bytes) noexcept {
+#if defined(MADV_HUGEPAGE)
+        if (bytes >= HUGE_PAGE_THRESHOLD) {
+            madvise(p, bytes, MADV_HUGEPAGE);
+        }
+#else
+        (void)p;
+        (void)bytes;
+#endif
+    }
+};
+
+// Формат бинарного снимка вектора: страница заголовка + сырые байты
+// элементов. Заголовок занимает целую страницу, чтобы данные начинались
+// со смещения, кратного странице, и файл можно было отобразить в память
+// прямо как буфер вектора — без единого копирования
+struct VectorSnapshotHeader {
+    char magic[8];
+    uint64_t element_size;
+    uint64_t element_count;
+};
+
+inline constexpr char VECTOR_SNAPSHOT_MAGIC[8] = {'A', 'V', 'S', 'N', 'A', 'P', '0', '1'};
+inline constexpr size_t VECTOR_SNAPSHOT_DATA_OFFSET = 4096;
+static_assert(sizeof(VectorSnapshotHeader) <= VECTOR_SNAPSHOT_DATA_OFFSET);
+
+// Аллокатор для буферов, адоптированных из файловых отображений:
+// освобождение — munmap, новые блоки (если загруженный вектор всё же
+// растёт) берутся анонимным mmap. Намеренно без reallocate: mremap
+// файлового отображения вышел бы за конец файла, поэтому рост всегда
+// переносит содержимое в анонимную память
+template <typename T>
+struct FileMappingAllocator {
+    static_assert(alignof(T) <= 4096, "mmap выравнивает блоки по границе страницы");
+
+    using value_type = T;
+
+    FileMappingAllocator() = default;
+
+    template <typename U>
+    FileMappingAllocator(const FileMappingAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        void* p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            ADVANCED_VECTOR_THROW_BAD_ALLOC;
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        munmap(p, n * sizeof(T));
+    }
+
+    bool operator==(const FileMappingAllocator&) const noexcept {
+        return true;
+    }
+
+    bool operator!=(const FileMappingAllocator&) const noexcept {
+        return false;
+    }
+};
+
+namespace detail {
+
+// Полная запись: повторяет write после EINTR и коротких записей
+inline bool WriteAll(int fd, const void* data, size_t bytes) noexcept {
+    const char* p = static_cast<const char*>(data);
+    while (bytes != 0) {
+        const ssize_t written = ::write(fd, p, bytes);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Полное чтение, симметрично WriteAll. false и на преждевременном EOF
+inline bool ReadAll(int fd, void* data, size_t bytes) noexcept {
+    char* p = static_cast<char*>(data);
+    while (bytes != 0) {
+        const ssize_t got = ::read(fd, p, bytes);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (got == 0) {
+            return false;
+        }
+        p += got;
+        bytes -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+}  // namespace detail
+#endif  // defined(__linux__)
+
+// Профилирование ёмкости строится поверх счётчиков статистики
+// и включает их автоматически
+#if defined(ADVANCED_VECTOR_CAPACITY_PROFILE) && !defined(ADVANCED_VECTOR_STATS)
+#define ADVANCED_VECTOR_STATS
+#endif
+
+#ifdef ADVANCED_VECTOR_STATS
+// Глобальные хуки телеметрии аллокаций. Вызываются из RawMemory::Allocate/
+// Deallocate и из путей переноса при росте; устанавливаются кодом приложения.
+// Вся инструментация существует только при сборке с ADVANCED_VECTOR_STATS
+// и не стоит ничего в обычных сборках
+struct VectorStatsHooks {
+    static inline void (*on_allocate)(size_t bytes) = nullptr;
+    static inline void (*on_deallocate)(size_t bytes) = nullptr;
+    static inline void (*on_relocate)(size_t bytes) = nullptr;
+};
+#endif
+
+#ifdef ADVANCED_VECTOR_CAPACITY_PROFILE
+// Общепроцессный агрегатор историй роста векторов (opt-in через
+// ADVANCED_VECTOR_CAPACITY_PROFILE). Вектор, помеченный ProfileAs(site_id),
+// сообщает сюда каждый переезд буфера и — при разрушении — итоговый размер.
+// Отчёт по сайтам показывает, где вектор хронически недорезервирует
+// (десятки реаллокаций на запрос) или перерезервирует (мегабайты пустой
+// ёмкости), и рекомендует значение для Reserve по собранным данным
+class CapacityProfiler {
+public:
+    // log2-корзины гистограмм: [0], [1], [2..3], [4..7], ...
+    static constexpr size_t NUM_BUCKETS = 33;
+
+    struct SiteRecord {
+        size_t vectors = 0;                 // сколько экземпляров разрушилось
+        size_t reallocations = 0;           // суммарно переездов буфера
+        size_t total_initial_capacity = 0;  // ёмкость на момент ProfileAs
+        size_t total_final_size = 0;
+        size_t max_final_size = 0;
+        size_t max_peak_capacity = 0;
+        size_t final_size_histogram[NUM_BUCKETS] = {};
+        size_t realloc_capacity_histogram[NUM_BUCKETS] = {};
+    };
+
+    static CapacityProfiler& Instance() {
+        static CapacityProfiler instance;
+        return instance;
+    }
+
+    void RecordRelocation(uint32_t site_id, size_t new_capacity) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        SiteRecord& rec = sites_[site_id];
+        ++rec.reallocations;
+        ++rec.realloc_capacity_histogram[Bucket(new_capacity)];
+    }
+
+    void RecordLifetime(uint32_t site_id, size_t initial_capacity, size_t final_size,
+        size_t peak_capacity) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        SiteRecord& rec = sites_[site_id];
+        ++rec.vectors;
+        rec.total_initial_capacity += initial_capacity;
+        rec.total_final_size += final_size;
+        rec.max_final_size = std::max(rec.max_final_size, final_size);
+        rec.max_peak_capacity = std::max(rec.max_peak_capacity, peak_capacity);
+        ++rec.final_size_histogram[Bucket(final_size)];
+    }
+
+    // Снимок статистики по сайту (пустая запись, если сайт не встречался)
+    SiteRecord GetSite(uint32_t site_id) const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        const auto it = sites_.find(site_id);
+        return it != sites_.end() ? it->second : SiteRecord{};
+    }
+
+    // Рекомендация для Reserve: максимальный наблюдавшийся итоговый размер.
+    // Резерв такого объёма устраняет все зафиксированные реаллокации сайта
+    size_t RecommendedReserve(uint32_t site_id) const {
+        return GetSite(site_id).max_final_size;
+    }
+
+    // Текстовый отчёт по всем сайтам: сколько векторов, сколько переездов,
+    // гистограмма итоговых размеров и рекомендуемый Reserve
+    void Report(std::ostream& out) const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        for (const auto& [site_id, rec] : sites_) {
+            const double reallocs_per_vector = rec.vectors != 0
+                ? static_cast<double>(rec.reallocations) / static_cast<double>(rec.vectors)
+                : 0.0;
+            const size_t avg_final = rec.vectors != 0 ? rec.total_final_size / rec.vectors : 0;
+            out << "site " << site_id << ": vectors=" << rec.vectors
+                << " reallocations=" << rec.reallocations
+                << " (" << reallocs_per_vector << "/vector)"
+                << " final_size avg=" << avg_final << " max=" << rec.max_final_size
+                << " peak_capacity=" << rec.max_peak_capacity << '\n';
+            PrintHistogram(out, "  final sizes:      ", rec.final_size_histogram);
+            PrintHistogram(out, "  realloc capacity: ", rec.realloc_capacity_histogram);
+            out << "  recommended Reserve(" << rec.max_final_size << ")";
+            if (rec.max_peak_capacity > rec.max_final_size * 2) {
+                out << "  [перерезервирование: пик ёмкости " << rec.max_peak_capacity << "]";
+            }
+            out << '\n';
+        }
+    }
+
+    void Reset() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        sites_.clear();
+    }
+
+private:
+    CapacityProfiler() = default;
+
+    static size_t Bucket(size_t value) noexcept {
+        size_t bucket = 0;
+        while (value != 0 && bucket + 1 < NUM_BUCKETS) {
+            value >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    static void PrintHistogram(std::ostream& out, const char* label,
+        const size_t (&histogram)[NUM_BUCKETS]) {
+        out << label;
+        for (size_t bucket = 0; bucket != NUM_BUCKETS; ++bucket) {
+            if (histogram[bucket] != 0) {
+                out << "[<" << (size_t{1} << bucket) << "]:" << histogram[bucket] << ' ';
+            }
+        }
+        out << '\n';
+    }
+
+    mutable std::mutex mutex_;
+    std::map<uint32_t, SiteRecord> sites_;
+};
+#endif  // ADVANCED_VECTOR_CAPACITY_PROFILE
+
+// Метка "выполнить параллельно" для крупных Reserve/Resize
+struct ParallelPolicy {};
+inline constexpr ParallelPolicy parallel;
+
+// Метка "не инициализировать новые элементы" для Resize
+struct DefaultInitPolicy {};
+inline constexpr DefaultInitPolicy default_init;
+
+// Политика роста по умолчанию — удвоение ёмкости, как и раньше
+struct GrowthPolicy2x {
+    static constexpr size_t Next(size_t capacity) noexcept {
+        return capacity == 0 ? 1 : capacity * 2;
+    }
+};
+
+// Более экономный рост в полтора раза для долгоживущих больших векторов
+struct GrowthPolicy1_5x {
+    static constexpr size_t Next(size_t capacity) noexcept {
+        return capacity < 2 ? capacity + 1 : capacity + capacity / 2;
+    }
+};
+
+// Аллокатор, выравнивающий каждый блок по границе Align байт (степень двойки).
+// Vector<float, AlignedAllocator<float, 64>> гарантирует, что GetAddress()/begin()
+// выровнены по кеш-линии/векторному регистру, и SIMD-циклы по такому буферу
+// могут использовать выровненные загрузки без пролога
+template <typename T, size_t Align>
+struct AlignedAllocator {
+    static_assert((Align & (Align - 1)) == 0, "Align должен быть степенью двойки");
+    static_assert(Align >= alignof(T), "Align не может быть слабее естественного выравнивания T");
+
+    using value_type = T;
+
+    // Перепривязка к другому типу сохраняет выравнивание
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(operator new(n * sizeof(T), std::align_val_t{Align}));
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        operator delete(p, std::align_val_t{Align});
+    }
+
+    bool operator==(const AlignedAllocator&) const noexcept {
+        return true;
+    }
+
+    bool operator!=(const AlignedAllocator&) const noexcept {
+        return false;
+    }
+};
+
+// Хранит сырой буфер под capacity_ элементов. Память берётся у аллокатора Alloc
+// (совместимого с std::allocator_traits), по умолчанию — у std::allocator,
+// что сохраняет прежнее поведение с operator new/delete
+template <typename T, typename Alloc = std::allocator<T>>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
 public:
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    ADVANCED_VECTOR_CONSTEXPR explicit RawMemory(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR explicit RawMemory(size_t capacity, const Alloc& alloc = Alloc{})
+        : alloc_(alloc)
+        , buffer_(Allocate(capacity))
         , capacity_(capacity) {
     }
 
-    ~RawMemory() {
-        Deallocate(buffer_);
+    // Принимает владение готовым буфером на capacity элементов. Буфер должен
+    // быть выделен совместимым аллокатором — освобождать его будет alloc_
+    ADVANCED_VECTOR_CONSTEXPR RawMemory(T* buffer, size_t capacity, const Alloc& alloc = Alloc{}) noexcept
+        : alloc_(alloc)
+        , buffer_(buffer)
+        , capacity_(capacity) {
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR ~RawMemory() {
+        Deallocate(buffer_, capacity_);
     }
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
 
-    RawMemory(RawMemory&& other) noexcept
-        : buffer_(std::exchange(other.buffer_, nullptr)),
+    ADVANCED_VECTOR_CONSTEXPR RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_)),
+        buffer_(std::exchange(other.buffer_, nullptr)),
         capacity_(std::exchange(other.capacity_, 0))
     {
     }
 
-    RawMemory& operator=(RawMemory&& rhs) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
-            Deallocate(buffer_);
+            Deallocate(buffer_, capacity_);
+            alloc_ = std::move(rhs.alloc_);
             buffer_ = std::exchange(rhs.buffer_, nullptr);
             capacity_ = std::exchange(rhs.capacity_, 0);
         }
         return *this;
     }
 
-    T* operator+(size_t offset) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const T* operator+(size_t offset) const noexcept {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
-        assert(index < capacity_);
+    ADVANCED_VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_VERIFY(index < capacity_);
         return buffer_[index];
     }
 
-    void Swap(RawMemory& other) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR void Swap(RawMemory& other) noexcept {
+        std::swap(alloc_, other.alloc_);
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
-    const T* GetAddress() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Пытается расширить буфер до new_capacity силами аллокатора (realloc-путь),
+    // не выделяя новый блок и не перенося элементы вручную. Возвращает false,
+    // если аллокатор расширение не поддерживает; буфер при этом не меняется
+    ADVANCED_VECTOR_CONSTEXPR bool TryExtend(size_t new_capacity) {
+        if constexpr (detail::HasReallocate<Alloc, T>::value) {
+            static_assert(IsTriviallyRelocatable<T>::value,
+                "reallocate переносит байты без вызова конструкторов");
+            if (buffer_ == nullptr) {
+                return false;
+            }
+            const size_t old_capacity = capacity_;
+            buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+            capacity_ = new_capacity;
+#ifdef ADVANCED_VECTOR_STATS
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+            if (std::is_constant_evaluated()) {
+                return true;
+            }
+#endif
+            // Расширение на месте — это тоже освобождение старого блока и
+            // выделение нового, иначе байтовый баланс хуков уйдёт в минус
+            if (VectorStatsHooks::on_deallocate != nullptr) {
+                VectorStatsHooks::on_deallocate(old_capacity * sizeof(T));
+            }
+            if (VectorStatsHooks::on_allocate != nullptr) {
+                VectorStatsHooks::on_allocate(new_capacity * sizeof(T));
+            }
+#else
+            (void)old_capacity;
+#endif
+            return true;
+        }
+        else {
+            (void)new_capacity;
+            return false;
+        }
+    }
+
+    // Отдаёт владение буфером вызывающему; RawMemory остаётся пустой
+    ADVANCED_VECTOR_CONSTEXPR T* Release() noexcept {
+        capacity_ = 0;
+        return std::exchange(buffer_, nullptr);
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const T* GetAddress() const noexcept {
         return buffer_;
     }
 
-    T* GetAddress() noexcept {
+    ADVANCED_VECTOR_CONSTEXPR T* GetAddress() noexcept {
         return buffer_;
     }
 
-    size_t Capacity() const {
+    ADVANCED_VECTOR_CONSTEXPR size_t Capacity() const {
         return capacity_;
     }
 
 private:
     // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    ADVANCED_VECTOR_CONSTEXPR T* Allocate(size_t n) {
+        T* p = n != 0 ? AllocTraits::allocate(alloc_, n) : nullptr;
+#ifdef ADVANCED_VECTOR_STATS
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+        if (std::is_constant_evaluated()) {
+            return p;
+        }
+#endif
+        if (p != nullptr && VectorStatsHooks::on_allocate != nullptr) {
+            VectorStatsHooks::on_allocate(n * sizeof(T));
+        }
+#endif
+        return p;
     }
 
     // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    ADVANCED_VECTOR_CONSTEXPR void Deallocate(T* buf, size_t n) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(alloc_, buf, n);
+#ifdef ADVANCED_VECTOR_STATS
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+            if (std::is_constant_evaluated()) {
+                return;
+            }
+#endif
+            if (VectorStatsHooks::on_deallocate != nullptr) {
+                VectorStatsHooks::on_deallocate(n * sizeof(T));
+            }
+#endif
+        }
     }
 
+    Alloc alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
 
-template <typename T>
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = GrowthPolicy2x>
 class Vector {
 public:
     Vector() = default;
 
-    explicit Vector(size_t size)
-        : data_(size),
+    ADVANCED_VECTOR_CONSTEXPR explicit Vector(const Alloc& alloc) noexcept
+        : data_(alloc) {
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR explicit Vector(size_t size, const Alloc& alloc = Alloc{})
+        : data_(size, alloc),
         size_(size)  //
     {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+        detail::ValueConstructN(data_.GetAddress(), size);
+        Annotate(Capacity(), size_);
     }
 
-    Vector(const Vector& other)
-        : data_(other.size_),
+    ADVANCED_VECTOR_CONSTEXPR Vector(const Vector& other)
+        : data_(other.size_, other.data_.GetAllocator()),
         size_(other.size_)  //
     {
-        std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
+        detail::UninitializedCopyN(other.data_.GetAddress(), size_, data_.GetAddress());
+        Annotate(Capacity(), size_);
     }
 
-    Vector(Vector&& other) noexcept
-        : data_(std::exchange(other.data_, RawMemory<T>{})),
+    ADVANCED_VECTOR_CONSTEXPR Vector(Vector&& other) noexcept
+        : data_(std::exchange(other.data_, RawMemory<T, Alloc>{other.data_.GetAllocator()})),
         size_(std::exchange(other.size_, 0))
     {
     }
 
-    Vector& operator=(const Vector& rhs) {
+    ADVANCED_VECTOR_CONSTEXPR Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
             if (rhs.size_ <= Capacity()) {
                 if (size_ <= rhs.size_) {
                     std::copy(rhs.data_.GetAddress(), rhs.data_.GetAddress() + size_,
                         data_.GetAddress());
-                    std::uninitialized_copy_n(
+                    Annotate(size_, rhs.size_);
+                    detail::UninitializedCopyN(
                         rhs.data_.GetAddress() + size_, rhs.size_ - size_,
                         data_.GetAddress() + size_);
                 }
@@ -130,6 +1011,7 @@ public:
                         data_.GetAddress());
                     std::destroy_n(data_.GetAddress() + rhs.size_,
                         size_ - rhs.size_);
+                    Annotate(size_, rhs.size_);
                 }
                 size_ = rhs.size_;
             }
@@ -141,164 +1023,635 @@ public:
         return *this;
     }
 
-    Vector& operator=(Vector&& rhs) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR Vector& operator=(Vector&& rhs) noexcept {
         Swap(rhs);
         return *this;
     }
 
-    void Swap(Vector& other) noexcept {
+    // Заменяет содержимое копиями элементов [first, last), по возможности
+    // переиспользуя уже выделенный буфер: живые элементы перезаписываются
+    // присваиванием, хвост доконструируется либо разрушается. При нехватке
+    // ёмкости рост геометрический, как в AppendRange, поэтому регулярные
+    // перезаливки стабильного размера совсем не выделяют память
+    // Требование "InputIt — итератор" отсекает этот шаблон при вызове
+    // Assign(count, value) с целочисленными аргументами
+    template <typename InputIt,
+        typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void Assign(InputIt first, InputIt last) {
+        if constexpr (IsForwardIterator<InputIt>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (count > Capacity()) {
+                // Старое содержимое всё равно погибнет — выгоднее уничтожить
+                // его до реаллокации и не переносить в новый буфер
+                DestroyN(data_.GetAddress(), size_);
+                Annotate(size_, 0);
+                size_ = 0;
+                Reserve(std::max(count, Growth::Next(Capacity())));
+            }
+            if (count <= size_) {
+                std::copy(first, last, data_.GetAddress());
+                std::destroy_n(data_.GetAddress() + count, size_ - count);
+                Annotate(size_, count);
+            }
+            else {
+                Annotate(size_, count);
+                InputIt mid = first;
+                std::advance(mid, size_);
+                std::copy(first, mid, data_.GetAddress());
+                std::uninitialized_copy(mid, last, data_.GetAddress() + size_);
+            }
+            size_ = count;
+        }
+        else {
+            // Однопроходный диапазон: перезаписываем существующие элементы,
+            // остаток дописываем в конец
+            size_t i = 0;
+            for (; first != last && i < size_; ++first, ++i) {
+                data_[i] = *first;
+            }
+            if (i < size_) {
+                std::destroy_n(data_.GetAddress() + i, size_ - i);
+                size_ = i;
+            }
+            for (; first != last; ++first) {
+                PushBack(*first);
+            }
+        }
+    }
+
+    // Заполняет вектор count копиями value, переиспользуя буфер тем же способом
+    void Assign(size_t count, const T& value) {
+        if (count > Capacity()) {
+            DestroyN(data_.GetAddress(), size_);
+            Annotate(size_, 0);
+            size_ = 0;
+            Reserve(std::max(count, Growth::Next(Capacity())));
+        }
+        if (count <= size_) {
+            std::fill_n(data_.GetAddress(), count, value);
+            std::destroy_n(data_.GetAddress() + count, size_ - count);
+            Annotate(size_, count);
+        }
+        else {
+            Annotate(size_, count);
+            std::fill_n(data_.GetAddress(), size_, value);
+            detail::UninitializedFillN(data_.GetAddress() + size_, count - size_, value);
+        }
+        size_ = count;
+    }
+
+    // Неизменяемый снимок содержимого для read-mostly сценариев. Копия
+    // снимка — одна атомарная операция над счётчиком ссылок, буфер
+    // разделяется всеми копиями и живёт, пока жив последний снимок.
+    // Публикация одного снимка N читателям стоит O(1) на читателя вместо
+    // полного uninitialized_copy_n на каждого
+    class Snapshot {
+    public:
+        Snapshot() = default;
+
+        const T* begin() const noexcept {
+            return owner_ != nullptr ? owner_->begin() : nullptr;
+        }
+
+        const T* end() const noexcept {
+            return owner_ != nullptr ? owner_->end() : nullptr;
+        }
+
+        size_t Size() const noexcept {
+            return owner_ != nullptr ? owner_->Size() : 0;
+        }
+
+        const T& operator[](size_t index) const noexcept {
+            return (*owner_)[index];
+        }
+
+        // Клонирование для модификации: единственная глубокая копия
+        // делается только тому читателю, который правда собрался писать
+        Vector ToVector() const {
+            return owner_ != nullptr ? *owner_ : Vector{};
+        }
+
+    private:
+        friend Vector;
+
+        explicit Snapshot(std::shared_ptr<const Vector> owner) noexcept
+            : owner_(std::move(owner)) {
+        }
+
+        std::shared_ptr<const Vector> owner_;
+    };
+
+    // Публикует снимок текущего содержимого. Из lvalue содержимое копируется
+    // один раз (дальнейшие правки вектора снимка не касаются); из rvalue
+    // буфер забирается перемещением — публикация обходится без копирования
+    Snapshot MakeSnapshot() const& {
+        return Snapshot(std::make_shared<const Vector>(*this));
+    }
+
+    Snapshot MakeSnapshot() && {
+        return Snapshot(std::make_shared<const Vector>(std::move(*this)));
+    }
+
+    // Результат ReleaseBuffer: сырой буфер и его параметры
+    struct ReleasedBuffer {
+        T* buffer;
+        size_t size;
+        size_t capacity;
+    };
+
+    // Отдаёт владение буфером вызывающему, вектор остаётся пустым. Живые
+    // элементы уходят вместе с буфером: их разрушение и освобождение памяти
+    // (тем же аллокатором, что её выделял) — забота нового владельца.
+    // Парный AdoptBuffer возвращает буфер обратно без единого копирования
+    ReleasedBuffer ReleaseBuffer() noexcept {
+        ReleasedBuffer released{nullptr, size_, Capacity()};
+        // Возвращаем ASan хвост буфера: новому владельцу уходит обычная память
+        Annotate(size_, Capacity());
+        released.buffer = data_.Release();
+        size_ = 0;
+        return released;
+    }
+
+    // Принимает владение совместимой памятью: первые size элементов должны
+    // быть сконструированы, capacity — реальный размер блока в элементах.
+    // Аллокатор задаёт и способ освобождения, поэтому так можно адоптировать
+    // и mmap- или пул-память — через Vector с соответствующим аллокатором
+    static Vector AdoptBuffer(T* buffer, size_t size, size_t capacity,
+        const Alloc& alloc = Alloc{}) noexcept {
+        assert(size <= capacity);
+        assert(buffer != nullptr || capacity == 0);
+        Vector adopted(alloc);
+        adopted.data_ = RawMemory<T, Alloc>(buffer, capacity, alloc);
+        adopted.size_ = size;
+        adopted.Annotate(capacity, size);
+        return adopted;
+    }
+
+#if defined(__linux__)
+    // Пишет бинарный снимок в открытый на запись дескриптор: страница
+    // заголовка и сырые байты всех элементов одним bulk-write вместо
+    // поэлементной сериализации. Парный LoadVectorSnapshot отображает
+    // такой файл в память без копирования. false при ошибке записи
+    bool SaveTo(int fd) const {
+        static_assert(std::is_trivially_copyable_v<T>,
+            "снимок пишет сырые байты: T должен быть тривиально копируемым");
+        alignas(VectorSnapshotHeader) unsigned char page[VECTOR_SNAPSHOT_DATA_OFFSET] = {};
+        auto* header = reinterpret_cast<VectorSnapshotHeader*>(page);
+        std::memcpy(header->magic, VECTOR_SNAPSHOT_MAGIC, sizeof(header->magic));
+        header->element_size = sizeof(T);
+        header->element_count = size_;
+        if (!detail::WriteAll(fd, page, sizeof(page))) {
+            return false;
+        }
+        return size_ == 0
+            || detail::WriteAll(fd, data_.GetAddress(), size_ * sizeof(T));
+    }
+
+    // Создаёт (или перезаписывает) файл снимка по пути
+    bool SaveTo(const char* path) const {
+        const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        const bool ok = SaveTo(fd);
+        ::close(fd);
+        return ok;
+    }
+#endif  // defined(__linux__)
+
+    ADVANCED_VECTOR_CONSTEXPR void Swap(Vector& other) noexcept {
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
     }
 
-    size_t Size() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR size_t Size() const noexcept {
         return size_;
     }
 
-    size_t Capacity() const noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+    // Счётчики по конкретному экземпляру вектора (только при сборке со статистикой)
+    struct Stats {
+        size_t reallocations = 0;      // сколько раз буфер переезжал
+        size_t peak_capacity = 0;      // максимальная достигнутая ёмкость
+        size_t bytes_relocated = 0;    // суммарно перенесено байт при росте
+    };
+
+    const Stats& GetStats() const noexcept {
+        return stats_;
+    }
+#endif
+
+#ifdef ADVANCED_VECTOR_CAPACITY_PROFILE
+    // Помечает экземпляр идентификатором места создания. Дальше каждый
+    // переезд буфера и итоговый размер при разрушении уходят в
+    // CapacityProfiler под этим site_id; 0 — не профилировать
+    void ProfileAs(uint32_t site_id) noexcept {
+        profile_site_ = site_id;
+        profile_initial_capacity_ = Capacity();
+    }
+#endif
+
+    ADVANCED_VECTOR_CONSTEXPR size_t Capacity() const noexcept {
         return data_.Capacity();
     }
 
-    const T& operator[](size_t index) const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
-        assert(index < size_);
+    ADVANCED_VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_VERIFY(index < size_);
         return data_[index];
     }
 
-    void Reserve(size_t new_capacity) {
+    ADVANCED_VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
         if (new_capacity <= Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
-        if constexpr
-            (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            // Аллокаторы с поддержкой reallocate могут дорастить блок на месте,
+            // избавляя от переноса всего содержимого. ASan не отслеживает
+            // пользовательский reallocate, поэтому на время вызова снимаем
+            // отравление и восстанавливаем его на новом блоке
+            Annotate(size_, Capacity());
+            if (data_.TryExtend(new_capacity)) {
+                Annotate(Capacity(), size_);
+                // Элементы не переезжали, но перевыделение и новая пиковая
+                // ёмкость должны попасть в счётчики
+                NoteRelocation(0);
+                return;
+            }
+            Annotate(Capacity(), size_);
+        }
+        RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+        RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+        DestroyRelocatedN(data_.GetAddress(), size_);
+        Annotate(size_, Capacity());
+        data_.Swap(new_data);
+        Annotate(Capacity(), size_);
+        NoteRelocation(size_);
+    }
+
+    // Сбрасывает неиспользуемую ёмкость, перевыделяя буфер точно под size_.
+    // Перенос элементов идёт той же логикой перемещения/копирования, что и в Reserve
+    // Параллельный вариант Reserve: перенос элементов в новый буфер режется
+    // на чанки по потокам. Применим, только когда перенос не бросает
+    // (nothrow-перемещение или memcpy); иначе работает последовательно
+    void Reserve(size_t new_capacity, ParallelPolicy) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+        if constexpr (IsTriviallyRelocatable<T>::value || std::is_nothrow_move_constructible_v<T>) {
+            T* from = data_.GetAddress();
+            T* to = new_data.GetAddress();
+            detail::ParallelFor(size_, [from, to](size_t lo, size_t hi) {
+                detail::RelocateN(from + lo, hi - lo, to + lo);
+            });
         }
         else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+            RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
         }
+        DestroyRelocatedN(data_.GetAddress(), size_);
+        Annotate(size_, Capacity());
+        data_.Swap(new_data);
+        Annotate(Capacity(), size_);
+        NoteRelocation(size_);
+    }
 
-        std::destroy_n(data_.GetAddress(), size_);
+    ADVANCED_VECTOR_CONSTEXPR void ShrinkToFit() {
+        if (Capacity() == size_) {
+            return;
+        }
+        RawMemory<T, Alloc> new_data(size_, data_.GetAllocator());
+        RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+        DestroyRelocatedN(data_.GetAddress(), size_);
+        Annotate(size_, Capacity());
         data_.Swap(new_data);
+        Annotate(Capacity(), size_);
+        NoteRelocation(size_);
     }
 
-    void Resize(size_t new_size) {
+    ADVANCED_VECTOR_CONSTEXPR void Resize(size_t new_size) {
         if (new_size < size_) {
             std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+            Annotate(size_, new_size);
         }
         else {
             if (new_size > Capacity()) {
                 Reserve(new_size);
             }
-            std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+            Annotate(size_, new_size);
+            detail::ValueConstructN(data_.GetAddress() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    // Resize без инициализации хвоста: ёмкость растёт, size_ увеличивается,
+    // но новые байты не трогаются — в них остаётся мусор. Для приёмных
+    // буферов, которые сразу перезаписываются целиком, это убирает
+    // бессмысленный memset. Разрешён только тривиальным типам
+    ADVANCED_VECTOR_CONSTEXPR void Resize(size_t new_size, DefaultInitPolicy) {
+        static_assert(std::is_trivially_default_constructible_v<T>
+            && std::is_trivially_destructible_v<T>,
+            "Resize(n, default_init) оставляет элементы несконструированными");
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+        if (std::is_constant_evaluated()) {
+            // В constant evaluation чтение неинициализированного объекта —
+            // ошибка компиляции, поэтому инициализируем как обычный Resize
+            Resize(new_size);
+            return;
         }
+#endif
+        if (new_size > Capacity()) {
+            Reserve(new_size);
+        }
+        Annotate(size_, new_size);
         size_ = new_size;
     }
 
-    void PushBack(const T& value) {
+    // Параллельный Resize для очень больших n: новые элементы конструируются
+    // чанками на нескольких потоках. Требует nothrow-конструирования по
+    // умолчанию; типы с бросающими конструкторами заполняются последовательно
+    void Resize(size_t new_size, ParallelPolicy) {
+        if (new_size <= size_) {
+            Resize(new_size);
+            return;
+        }
+        if (new_size > Capacity()) {
+            Reserve(new_size, parallel);
+        }
+        Annotate(size_, new_size);
+        if constexpr (std::is_nothrow_default_constructible_v<T>) {
+            T* base = data_.GetAddress() + size_;
+            detail::ParallelFor(new_size - size_, [base](size_t lo, size_t hi) {
+                detail::ValueConstructN(base + lo, hi - lo);
+            });
+        }
+        else {
+            detail::ValueConstructN(data_.GetAddress() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void PushBack(const T& value) {
         (void)EmplaceBack(value);
     }
 
-    void PushBack(T&& value) {
+    ADVANCED_VECTOR_CONSTEXPR void PushBack(T&& value) {
         (void)EmplaceBack(std::move(value));
     }
 
-    void PopBack() /* noexcept */ {
+    ADVANCED_VECTOR_CONSTEXPR void PopBack() /* noexcept */ {
         assert(size_);
         std::destroy_at(data_.GetAddress() + size_ - 1);
         --size_;
+        Annotate(size_ + 1, size_);
+    }
+
+    // Снимает count последних элементов одним destroy_n вместо цикла
+    // PopBack; для тривиально разрушаемых типов — просто уменьшение size_
+    ADVANCED_VECTOR_CONSTEXPR void PopBackN(size_t count) noexcept {
+        assert(count <= size_);
+        Truncate(size_ - count);
+    }
+
+    // Обрезает вектор до new_size элементов, разрушая хвост одним проходом
+    ADVANCED_VECTOR_CONSTEXPR void Truncate(size_t new_size) noexcept {
+        assert(new_size <= size_);
+        DestroyN(data_.GetAddress() + new_size, size_ - new_size);
+        Annotate(size_, new_size);
+        size_ = new_size;
+    }
+
+    // Разрушает все элементы, сохраняя ёмкость — следующая заливка того же
+    // объёма не выделяет память. Для тривиально разрушаемых типов
+    // компилируется в одно присваивание size_ = 0
+    ADVANCED_VECTOR_CONSTEXPR void Clear() noexcept {
+        Truncate(0);
     }
 
     template <typename... Args>
-    T& EmplaceBack(Args&&... args) {
+    ADVANCED_VECTOR_CONSTEXPR T& EmplaceBack(Args&&... args) {
         if (Capacity() <= size_) {
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-            new (new_data.GetAddress() + size_) T(std::forward<Args>(args)...);
-            try {
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                    std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-                }
-                else {
-                    std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-                }
-            } catch (...) {
-                std::destroy_at(new_data + size_);
-                throw;
-            }
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
-        }
-        else {
-            new (data_.GetAddress() + size_) T(std::forward<Args>(args)...);
+            // Холодная ветка роста вынесена в отдельную невстраиваемую
+            // функцию, чтобы горячий цикл вставки оставался коротким
+            return EmplaceBackSlow(std::forward<Args>(args)...);
         }
+        Annotate(size_, size_ + 1);
+        detail::ConstructAt(data_.GetAddress() + size_, std::forward<Args>(args)...);
+        return data_[size_++];
+    }
+
+    // Версии для заранее зарезервированного места: вызывающий гарантирует
+    // (а отладочная сборка проверяет), что ёмкости хватает. Тело сводится
+    // к placement new и инкременту размера — ни ветки роста, ни холодного
+    // кода реаллокации в горячем цикле
+    ADVANCED_VECTOR_CONSTEXPR void PushBackUnchecked(const T& value) {
+        (void)EmplaceBackUnchecked(value);
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR void PushBackUnchecked(T&& value) {
+        (void)EmplaceBackUnchecked(std::move(value));
+    }
+
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR T& EmplaceBackUnchecked(Args&&... args) {
+        assert(size_ < Capacity());
+        Annotate(size_, size_ + 1);
+        detail::ConstructAt(data_.GetAddress() + size_, std::forward<Args>(args)...);
         return data_[size_++];
     }
 
+    // Не бросающие варианты для кода, где нехватка памяти — ожидаемая
+    // ситуация: неудача выделения (или бросивший конструктор элемента)
+    // превращается в false, вектор остаётся в прежнем состоянии.
+    // При -fno-exceptions аллокатор сам завершает процесс на OOM, поэтому
+    // возврат false там невозможен
+    bool TryReserve(size_t new_capacity) {
+#if ADVANCED_VECTOR_HAS_EXCEPTIONS
+        try {
+            Reserve(new_capacity);
+        } catch (...) {
+            return false;
+        }
+#else
+        Reserve(new_capacity);
+#endif
+        return true;
+    }
+
+    bool TryPushBack(const T& value) {
+        return TryEmplaceBack(value);
+    }
+
+    bool TryPushBack(T&& value) {
+        return TryEmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    bool TryEmplaceBack(Args&&... args) {
+#if ADVANCED_VECTOR_HAS_EXCEPTIONS
+        try {
+            (void)EmplaceBack(std::forward<Args>(args)...);
+        } catch (...) {
+            return false;
+        }
+#else
+        (void)EmplaceBack(std::forward<Args>(args)...);
+#endif
+        return true;
+    }
+
+    // Стандартный интерфейс контейнера: вложенные типы и lowercase-доступ,
+    // чтобы Vector удовлетворял требованиям contiguous range и работал
+    // с std::ranges и параллельными стандартными алгоритмами без копирования
+    // в std::vector
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
     using iterator = T*;
     using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-    iterator begin() noexcept {
+    ADVANCED_VECTOR_CONSTEXPR iterator begin() noexcept {
         return data_.GetAddress();
     }
 
-    iterator end() noexcept {
+    ADVANCED_VECTOR_CONSTEXPR iterator end() noexcept {
         return data_.GetAddress() + size_;
     }
 
-    const_iterator begin() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const_iterator begin() const noexcept {
         return data_.GetAddress();
     }
 
-    const_iterator end() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const_iterator end() const noexcept {
         return data_.GetAddress() + size_;
     }
 
-    const_iterator cbegin() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const_iterator cbegin() const noexcept {
         return begin();
     }
 
-    const_iterator cend() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const_iterator cend() const noexcept {
         return end();
     }
 
+    ADVANCED_VECTOR_CONSTEXPR reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR T* data() noexcept {
+        return data_.GetAddress();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const T* data() const noexcept {
+        return data_.GetAddress();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR size_t size() const noexcept {
+        return size_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR T& front() noexcept {
+        assert(size_ > 0);
+        return data_[0];
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const T& front() const noexcept {
+        return const_cast<Vector&>(*this).front();
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR T& back() noexcept {
+        assert(size_ > 0);
+        return data_[size_ - 1];
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const T& back() const noexcept {
+        return const_cast<Vector&>(*this).back();
+    }
+
     template <typename... Args>
     iterator Emplace(const_iterator pos, Args&&... args) {
         assert(pos >= begin() && pos <= end());
         auto distance = std::distance(cbegin(), pos);
 
         if (Capacity() <= size_) {
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                T value(std::forward<Args>(args)...);
+                Reserve(Growth::Next(Capacity()));
+                Annotate(size_, size_ + 1);
+                // Подсказка оптимизатору: инвариант distance <= size_ теряется
+                // за невстраиваемым Reserve, и GCC иначе выводит для memmove
+                // завышенную границу (-Wstringop-overflow)
+                ADVANCED_VECTOR_VERIFY(static_cast<size_t>(distance) <= size_);
+                std::memmove(static_cast<void*>(begin() + distance + 1), begin() + distance,
+                    (size_ - distance) * sizeof(T));
+                new (begin() + distance) T(value);
+                ++size_;
+                return begin() + distance;
+            }
+            RawMemory<T, Alloc> new_data(Growth::Next(Capacity()), data_.GetAllocator());
             new (new_data.GetAddress() + distance) T(std::forward<Args>(args)...);
-            try {
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                    std::uninitialized_move_n(data_.GetAddress(), distance, new_data.GetAddress());
-                    std::uninitialized_move_n(data_.GetAddress() + distance, size_ - distance,
-                    new_data.GetAddress() + distance + 1);
-                }
-                else {
-                    std::uninitialized_copy_n(data_.GetAddress(), distance, new_data.GetAddress());
-                    std::uninitialized_copy_n(data_.GetAddress() + distance, size_ - distance,
+            size_t alive_from = distance;
+            ADVANCED_VECTOR_TRY {
+                RelocateN(data_.GetAddress(), distance, new_data.GetAddress());
+                alive_from = 0;
+                RelocateN(data_.GetAddress() + distance, size_ - distance,
                     new_data.GetAddress() + distance + 1);
-                }
-            } catch (...) {
-                std::destroy_n(new_data.GetAddress(), distance + 1);
-                throw;
+            } ADVANCED_VECTOR_CATCH_ALL {
+                // Живы только новый элемент и успешно перенесённый префикс
+                std::destroy_n(new_data.GetAddress() + alive_from,
+                    distance + 1 - alive_from);
+                ADVANCED_VECTOR_RETHROW;
             }
-            std::destroy_n(data_.GetAddress(), size_);
+            DestroyRelocatedN(data_.GetAddress(), size_);
+            Annotate(size_, Capacity());
             data_.Swap(new_data);
+            Annotate(Capacity(), size_ + 1);
+            NoteRelocation(size_);
         }
         else {
+                Annotate(size_, size_ + 1);
                 if (pos != end()) {
                     T new_value(std::forward<Args>(args)...);
                     new (end()) T(std::forward<T>(data_[size_ - 1]));
-                    try {
+                    ADVANCED_VECTOR_TRY {
                         std::move_backward(begin() + distance, end() - 1, end());
-                    } catch (...) {
+                    } ADVANCED_VECTOR_CATCH_ALL {
                         std::destroy_at(end());
-                        throw;
+                        ADVANCED_VECTOR_RETHROW;
                     }
                     
                     *(begin() + distance) = std::forward<T>(new_value);
@@ -316,12 +1669,68 @@ public:
     iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
         assert(pos >= cbegin() && (pos < cbegin() + Size()));
         size_t distance = std::distance(cbegin(), pos);
-        std::move(begin() + distance + 1, end(), begin() + distance);
-        std::destroy_at(end() - 1);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memmove(static_cast<void*>(begin() + distance), begin() + distance + 1,
+                (size_ - distance - 1) * sizeof(T));
+        }
+        else {
+            std::move(begin() + distance + 1, end(), begin() + distance);
+            std::destroy_at(end() - 1);
+        }
         --size_;
+        Annotate(size_ + 1, size_);
         return (begin() + distance);
     }
 
+    // Удаляет диапазон [first, last), сдвигая хвост ровно один раз.
+    // Возвращает итератор на элемент, следовавший за last
+    iterator Erase(const_iterator first, const_iterator last)
+        noexcept(std::is_nothrow_move_assignable_v<T>) {
+        assert(first >= cbegin() && first <= last && last <= cend());
+        const size_t from = static_cast<size_t>(first - cbegin());
+        const size_t count = static_cast<size_t>(last - first);
+        if (count != 0) {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                std::memmove(static_cast<void*>(begin() + from), begin() + from + count,
+                    (size_ - from - count) * sizeof(T));
+            }
+            else {
+                std::move(begin() + from + count, end(), begin() + from);
+                std::destroy_n(end() - count, count);
+            }
+            size_ -= count;
+            Annotate(size_ + count, size_);
+        }
+        return begin() + from;
+    }
+
+    // Удаляет все элементы, удовлетворяющие pred, одним уплотняющим проходом
+    // в духе remove_if. Возвращает число удалённых элементов
+    template <typename Pred>
+    size_t EraseIf(Pred pred) {
+        iterator new_end = std::remove_if(begin(), end(), pred);
+        const size_t removed = static_cast<size_t>(end() - new_end);
+        DestroyN(new_end, removed);
+        size_ -= removed;
+        Annotate(size_ + removed, size_);
+        return removed;
+    }
+
+    // Удаляет элемент за O(1), перемещая на его место последний элемент.
+    // Порядок оставшихся элементов не сохраняется
+    iterator UnorderedErase(const_iterator pos)
+        noexcept(std::is_nothrow_move_assignable_v<T>) {
+        assert(pos >= cbegin() && pos < cend());
+        const size_t distance = static_cast<size_t>(pos - cbegin());
+        if (distance + 1 != size_) {
+            data_[distance] = std::move(data_[size_ - 1]);
+        }
+        std::destroy_at(data_.GetAddress() + size_ - 1);
+        --size_;
+        Annotate(size_ + 1, size_);
+        return begin() + distance;
+    }
+
     iterator Insert(const_iterator pos, const T& value) {
         return Emplace(pos, value);
     }
@@ -330,11 +1739,343 @@ public:
         return Emplace(pos, std::move(value));
     }
 
-    ~Vector() {
-        std::destroy_n(data_.GetAddress(), size_);
+    // Дописывает диапазон [first, last) в конец вектора. Итоговый размер
+    // вычисляется заранее, поэтому реаллокация происходит не более одного раза
+    template <typename InputIt>
+    void AppendRange(InputIt first, InputIt last) {
+        if constexpr (IsForwardIterator<InputIt>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (size_ + count > Capacity()) {
+                Reserve(std::max(size_ + count, Growth::Next(Capacity())));
+            }
+            Annotate(size_, size_ + count);
+            std::uninitialized_copy(first, last, data_.GetAddress() + size_);
+            size_ += count;
+        }
+        else {
+            // Однопроходные итераторы не позволяют узнать размер заранее
+            for (; first != last; ++first) {
+                PushBack(*first);
+            }
+        }
+    }
+
+    // Вставляет диапазон [first, last) перед pos, сдвигая хвост ровно один раз.
+    // Возвращает итератор на первый вставленный элемент
+    template <typename InputIt>
+    iterator InsertRange(const_iterator pos, InputIt first, InputIt last) {
+        assert(pos >= begin() && pos <= end());
+        const size_t distance = static_cast<size_t>(pos - begin());
+        if constexpr (!IsForwardIterator<InputIt>) {
+            // Собираем однопроходный диапазон во временный вектор и вставляем его
+            Vector tmp(data_.GetAllocator());
+            tmp.AppendRange(std::move(first), std::move(last));
+            return InsertRange(pos, tmp.begin(), tmp.end());
+        }
+        else {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (count == 0) {
+                return begin() + distance;
+            }
+
+            if (size_ + count > Capacity()) {
+                RawMemory<T, Alloc> new_data(std::max(size_ + count, Growth::Next(Capacity())),
+                    data_.GetAllocator());
+                std::uninitialized_copy(first, last, new_data.GetAddress() + distance);
+                size_t alive_from = distance;
+                ADVANCED_VECTOR_TRY {
+                    RelocateN(data_.GetAddress(), distance, new_data.GetAddress());
+                    alive_from = 0;
+                    RelocateN(data_.GetAddress() + distance, size_ - distance,
+                        new_data.GetAddress() + distance + count);
+                } ADVANCED_VECTOR_CATCH_ALL {
+                    std::destroy_n(new_data.GetAddress() + alive_from,
+                        distance + count - alive_from);
+                    ADVANCED_VECTOR_RETHROW;
+                }
+                DestroyRelocatedN(data_.GetAddress(), size_);
+                Annotate(size_, Capacity());
+                data_.Swap(new_data);
+                Annotate(Capacity(), size_ + count);
+                NoteRelocation(size_);
+            }
+            else {
+                const size_t tail = size_ - distance;
+                Annotate(size_, size_ + count);
+                if (count < tail) {
+                    std::uninitialized_move_n(end() - count, count, end());
+                    std::move_backward(begin() + distance, end() - count, end());
+                    std::copy(first, last, begin() + distance);
+                }
+                else {
+                    InputIt mid = first;
+                    std::advance(mid, tail);
+                    std::uninitialized_move_n(begin() + distance, tail,
+                        begin() + distance + count);
+                    std::copy(first, mid, begin() + distance);
+                    std::uninitialized_copy(mid, last, end());
+                }
+            }
+            size_ += count;
+            return begin() + distance;
+        }
+    }
+
+    // Вставляет count копий value перед pos. Хвост сдвигается ровно один раз
+    // на count позиций, поэтому пакетная вставка стоит O(n + count), а не
+    // count отдельных вызовов Insert по O(n) каждый.
+    // Возвращает итератор на первый вставленный элемент
+    iterator InsertN(const_iterator pos, size_t count, const T& value) {
+        assert(pos >= begin() && pos <= end());
+        const size_t distance = static_cast<size_t>(pos - begin());
+        if (count == 0) {
+            return begin() + distance;
+        }
+
+        if (size_ + count > Capacity()) {
+            // Новый буфер заполняется за один проход: сначала вставляемые
+            // копии, затем перенос префикса и хвоста вокруг них
+            RawMemory<T, Alloc> new_data(std::max(size_ + count, Growth::Next(Capacity())),
+                data_.GetAllocator());
+            std::uninitialized_fill_n(new_data.GetAddress() + distance, count, value);
+            size_t alive_from = distance;
+            ADVANCED_VECTOR_TRY {
+                RelocateN(data_.GetAddress(), distance, new_data.GetAddress());
+                alive_from = 0;
+                RelocateN(data_.GetAddress() + distance, size_ - distance,
+                    new_data.GetAddress() + distance + count);
+            } ADVANCED_VECTOR_CATCH_ALL {
+                std::destroy_n(new_data.GetAddress() + alive_from,
+                    distance + count - alive_from);
+                ADVANCED_VECTOR_RETHROW;
+            }
+            DestroyRelocatedN(data_.GetAddress(), size_);
+            Annotate(size_, Capacity());
+            data_.Swap(new_data);
+            Annotate(Capacity(), size_ + count);
+            NoteRelocation(size_);
+        }
+        else {
+            // value может ссылаться на элемент этого же вектора и после
+            // сдвига хвоста оказаться перемещённой — работаем с копией
+            const T value_copy(value);
+            const size_t tail = size_ - distance;
+            Annotate(size_, size_ + count);
+            if (count < tail) {
+                std::uninitialized_move_n(end() - count, count, end());
+                std::move_backward(begin() + distance, end() - count, end());
+                std::fill_n(begin() + distance, count, value_copy);
+            }
+            else {
+                std::uninitialized_move_n(begin() + distance, tail,
+                    begin() + distance + count);
+                std::fill_n(begin() + distance, tail, value_copy);
+                std::uninitialized_fill_n(begin() + size_, count - tail, value_copy);
+            }
+        }
+        size_ += count;
+        return begin() + distance;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR ~Vector() {
+        NoteProfile();
+        DestroyN(data_.GetAddress(), size_);
+        // Снять отравление перед возвратом блока аллокатору
+        Annotate(size_, Capacity());
     }
 
 private:
-    RawMemory<T> data_;
+    // true для итераторов, по которым диапазон можно пройти более одного раза
+    // и заранее узнать его размер через std::distance
+    template <typename It>
+    static constexpr bool IsForwardIterator =
+        std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<It>::iterator_category>;
+
+    // Рост с реаллокацией для EmplaceBack. Не встраивается, чтобы не
+    // раздувать тело быстрой ветки
+    template <typename... Args>
+    ADVANCED_VECTOR_NOINLINE ADVANCED_VECTOR_CONSTEXPR T& EmplaceBackSlow(Args&&... args) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            // Аргументы могут указывать внутрь текущего буфера, поэтому значение
+            // собирается до расширения. Reserve при возможности дорастит блок
+            // на месте через TryExtend
+            T value(std::forward<Args>(args)...);
+            Reserve(Growth::Next(Capacity()));
+            Annotate(size_, size_ + 1);
+            detail::ConstructAt(data_.GetAddress() + size_, value);
+        }
+        else {
+            RawMemory<T, Alloc> new_data(Growth::Next(Capacity()), data_.GetAllocator());
+            detail::ConstructAt(new_data.GetAddress() + size_, std::forward<Args>(args)...);
+            ADVANCED_VECTOR_TRY {
+                RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+            } ADVANCED_VECTOR_CATCH_ALL {
+                std::destroy_at(new_data + size_);
+                ADVANCED_VECTOR_RETHROW;
+            }
+            DestroyRelocatedN(data_.GetAddress(), size_);
+            Annotate(size_, Capacity());
+            data_.Swap(new_data);
+            Annotate(Capacity(), size_ + 1);
+            NoteRelocation(size_);
+        }
+        return data_[size_++];
+    }
+
+    // Сообщает ASan новую границу между живыми элементами и хвостом
+    // буфера: [size, capacity) отравляется, и обращения туда ловятся
+    // санитайзером. Без ADVANCED_VECTOR_ASAN раскрывается в ничто.
+    // Аннотируется только память из std::allocator: для прочих аллокаторов
+    // (aligned new, mmap, realloc) ASan не знает геометрию блока и его
+    // внутренние проверки срабатывают ложно — стандартные библиотеки по
+    // той же причине аннотируют только std::vector<T, std::allocator<T>>
+    ADVANCED_VECTOR_CONSTEXPR void Annotate(size_t old_size, size_t new_size) const noexcept {
+        AnnotateBuffer(data_.GetAddress(), Capacity(), old_size, new_size);
+    }
+
+    static ADVANCED_VECTOR_CONSTEXPR void AnnotateBuffer(const T* buffer, size_t capacity,
+        size_t old_size, size_t new_size) noexcept {
+#ifdef ADVANCED_VECTOR_ASAN
+        if constexpr (std::is_same_v<Alloc, std::allocator<T>>) {
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+            if (std::is_constant_evaluated()) {
+                return;
+            }
+#endif
+            if (buffer == nullptr) {
+                return;
+            }
+            const char* beg = reinterpret_cast<const char*>(buffer);
+            __sanitizer_annotate_contiguous_container(beg, beg + capacity * sizeof(T),
+                beg + old_size * sizeof(T), beg + new_size * sizeof(T));
+            return;
+        }
+#endif
+        (void)buffer;
+        (void)capacity;
+        (void)old_size;
+        (void)new_size;
+    }
+
+    // Учитывает переезд буфера: счётчики экземпляра и глобальный хук.
+    // Без ADVANCED_VECTOR_STATS раскрывается в ничто
+    ADVANCED_VECTOR_CONSTEXPR void NoteRelocation(size_t moved_count) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+        ++stats_.reallocations;
+        stats_.peak_capacity = std::max(stats_.peak_capacity, Capacity());
+        stats_.bytes_relocated += moved_count * sizeof(T);
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+        if (std::is_constant_evaluated()) {
+            return;
+        }
+#endif
+        if (VectorStatsHooks::on_relocate != nullptr) {
+            VectorStatsHooks::on_relocate(moved_count * sizeof(T));
+        }
+#ifdef ADVANCED_VECTOR_CAPACITY_PROFILE
+        if (profile_site_ != 0) {
+            CapacityProfiler::Instance().RecordRelocation(profile_site_, Capacity());
+        }
+#endif
+#else
+        (void)moved_count;
+#endif
+    }
+
+    // Отправляет историю жизни профилируемого экземпляра агрегатору.
+    // Без ADVANCED_VECTOR_CAPACITY_PROFILE раскрывается в ничто
+    ADVANCED_VECTOR_CONSTEXPR void NoteProfile() noexcept {
+#ifdef ADVANCED_VECTOR_CAPACITY_PROFILE
+#if ADVANCED_VECTOR_HAS_CONSTEXPR
+        if (std::is_constant_evaluated()) {
+            return;
+        }
+#endif
+        if (profile_site_ != 0) {
+            CapacityProfiler::Instance().RecordLifetime(profile_site_,
+                profile_initial_capacity_, size_,
+                std::max(Capacity(), stats_.peak_capacity));
+        }
+#endif
+    }
+
+    // Короткие имена для общих хелперов переноса/разрушения из detail
+    static ADVANCED_VECTOR_CONSTEXPR void RelocateN(T* from, size_t count, T* to) {
+        detail::RelocateN(from, count, to);
+    }
+
+    static ADVANCED_VECTOR_CONSTEXPR void DestroyN(T* buf, size_t count) noexcept {
+        detail::DestroyN(buf, count);
+    }
+
+    static ADVANCED_VECTOR_CONSTEXPR void DestroyRelocatedN(T* buf, size_t count) noexcept {
+        detail::DestroyRelocatedN(buf, count);
+    }
+
+    RawMemory<T, Alloc> data_;
     size_t size_ = 0;
-};
\ No newline at end of file
+#ifdef ADVANCED_VECTOR_STATS
+    Stats stats_;
+#endif
+#ifdef ADVANCED_VECTOR_CAPACITY_PROFILE
+    uint32_t profile_site_ = 0;
+    size_t profile_initial_capacity_ = 0;
+#endif
+};
+#if defined(__linux__)
+// Загружает снимок, записанный Vector::SaveTo, отображая файл в память:
+// байты элементов становятся буфером вектора без копирования, страницы
+// подтягиваются ядром по требованию. MAP_PRIVATE даёт copy-on-write —
+// запись в элемент копирует только его страницу, файл не меняется.
+// false, если файл не открылся или заголовок не совпал с T.
+// Загруженный вектор заполнен под завязку (Size() == Capacity());
+// его рост уводит содержимое в анонимную память обычным переездом
+template <typename T, typename Growth = GrowthPolicy2x>
+bool LoadVectorSnapshot(const char* path, Vector<T, FileMappingAllocator<T>, Growth>& out) {
+    static_assert(std::is_trivially_copyable_v<T>,
+        "снимок содержит сырые байты: T должен быть тривиально копируемым");
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    VectorSnapshotHeader header{};
+    if (!detail::ReadAll(fd, &header, sizeof(header))
+        || std::memcmp(header.magic, VECTOR_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0
+        || header.element_size != sizeof(T)) {
+        ::close(fd);
+        return false;
+    }
+
+    // Оборванный снимок (диск закончился, SaveTo прервали) короче, чем
+    // обещает заголовок; отображение за концом файла умерло бы с SIGBUS
+    // при первом обращении — отклоняем такой файл заранее. Сверяем число
+    // элементов с размером файла делением, а не умножением: в испорченном
+    // или подделанном заголовке element_count может быть настолько велик,
+    // что произведение переполнится и проверка «пройдёт»
+    struct stat file_info {};
+    if (fstat(fd, &file_info) != 0
+        || static_cast<uint64_t>(file_info.st_size) < VECTOR_SNAPSHOT_DATA_OFFSET
+        || header.element_count
+            > (static_cast<uint64_t>(file_info.st_size) - VECTOR_SNAPSHOT_DATA_OFFSET)
+                / sizeof(T)) {
+        ::close(fd);
+        return false;
+    }
+    const size_t count = static_cast<size_t>(header.element_count);
+    T* buffer = nullptr;
+    if (count != 0) {
+        void* p = mmap(nullptr, count * sizeof(T), PROT_READ | PROT_WRITE,
+            MAP_PRIVATE, fd, VECTOR_SNAPSHOT_DATA_OFFSET);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        buffer = static_cast<T*>(p);
+    }
+    // Отображение живёт независимо от дескриптора
+    ::close(fd);
+    out = Vector<T, FileMappingAllocator<T>, Growth>::AdoptBuffer(buffer, count, count);
+    return true;
+}
+#endif  // defined(__linux__)